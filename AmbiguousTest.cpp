@@ -0,0 +1,58 @@
+#include "ArgParser.h"
+#include "Test.h"
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        CppArgParser::ArgParser args(argc, argv, "Test the CppArgParser");
+
+        bool twice = false;
+        args.param(twice, "--twice", "add a second unbounded parameter");
+        bool by_value = false;
+        args.param(by_value, "--by-value", "return b instead of binding it");
+
+        // like "cp srcs... dst": the last value is for b, the rest for a
+        std::vector<int> values;
+        args.param(values, "a", "N ints");
+        ArgParserType::N last = 0;
+        if (by_value)
+            last = args.param<ArgParserType::N>("b", "one int");
+        else
+            args.param(last, "b", "one int");
+
+        // but two parameters cannot share what is left
+        std::vector<int> more;
+        if (twice)
+            args.param(more, "c", "N ints");
+
+        // parse
+        if (!args.valid())
+        {
+            return 1;
+        };
+
+        dump("values:  ", values);
+        dump("last:    ", last);
+    }
+    catch (std::runtime_error& e)
+    {
+        if (e.what())
+            std::cerr << "ERROR: " << e.what();
+        return 1;
+    }
+    catch (std::exception& e)
+    {
+        if (e.what())
+            std::cerr << "exception: " << e.what();
+        std::cerr << "Unhandled exception!" << std::endl;
+        return 1;
+    }
+    
+    return 0;
+}
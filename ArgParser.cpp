@@ -0,0 +1,7 @@
+// the CppArgParser library: the non-template parts of ArgParser and 
+// ArgParser::param for the types listed in ArgParserLib.h
+#define CPPARGPARSER_INLINE
+#include "ArgParser.h"
+#include "ArgParserLib.h"
+
+CPPARGPARSER_TYPES(CPPARGPARSER_INSTANTIATE_TEMPLATES)
@@ -1,39 +1,145 @@
 #pragma once
+#include "ArgParserCore.h"
+#include "FlatMap.h"
 #include <string>
-#include <memory>
 #include <deque>
 #include <array>
 #include <vector>
+#include <map>
+#include <unordered_map>
 #include <sstream>
-#include <iostream>
-#include <iomanip>
+#include <istream>
 #include <stdexcept>
+#include <functional>
+#include <typeinfo>
+#include <type_traits>
+#include <cstring>
+#include <cstdint>
+#include <cctype>
+#include <iterator>
+#include <algorithm>
+#include <limits>
+#include <cstdlib>
 
 namespace CppArgParser
 {
     
-    typedef std::string Name;
-    typedef std::deque<std::string> Args;
-        
     class bad_lexical_cast {};
 
+    // any other type is read with its operator>>
+    template<typename T, typename Enable = void>
+    struct LexicalCast
+    {
+        static T convert(const std::string& value)
+        {
+            try
+            {
+                std::istringstream strm(value);
+                strm.exceptions(std::istringstream::failbit | std::istringstream::badbit);
+                T t;
+                strm >> t;
+                if (!strm.eof())
+                    throw bad_lexical_cast();
+                return t;
+            }
+            catch (std::istringstream::failure&)
+            {
+                throw bad_lexical_cast();
+            }
+        }
+    };
+
+    // integers are read as std::istream would read them (leading whitespace, 
+    // an optional sign and decimal digits, range checked, and a minus sign 
+    // wraps unsigned types) but without constructing a stream and its locale.
     template<typename T>
-    T lexical_cast(std::string value)
+    struct LexicalCast<T, typename std::enable_if<std::is_integral<T>::value>::type>
     {
-        try
+        static T convert(const std::string& value)
         {
-            std::istringstream strm(value);
-            strm.exceptions(std::istringstream::failbit | std::istringstream::badbit);
-            T t;
-            strm >> t;
-            if (!strm.eof())
+            size_t pos = value.find_first_not_of(" \t\n\v\f\r");
+            if (pos == std::string::npos)
                 throw bad_lexical_cast();
-            return t;
+            bool negative = value[pos] == '-';
+            if (value[pos] == '-' || value[pos] == '+')
+                pos++;
+            if (pos == value.size())
+                throw bad_lexical_cast();
+
+            unsigned long long limit = std::numeric_limits<T>::max();
+            if (std::is_signed<T>::value && negative)
+                limit++;
+            unsigned long long result = 0;
+            for (; pos < value.size(); ++pos)
+            {
+                if (value[pos] < '0' || value[pos] > '9')
+                    throw bad_lexical_cast();
+                unsigned digit = value[pos] - '0';
+                if (result > (limit - digit) / 10)
+                    throw bad_lexical_cast();
+                result = result * 10 + digit;
+            }
+            return negative ? T(0 - result) : T(result);
         }
-        catch (std::istringstream::failure&)
+    };
+
+    // floating point values go through strtod, which is what std::istream 
+    // uses in the end.  like the stream, it only takes decimal notation and 
+    // fails on overflow.
+    inline float strto(const char* begin, char** end, float*)
+    {
+        return std::strtof(begin, end);
+    }
+
+    inline double strto(const char* begin, char** end, double*)
+    {
+        return std::strtod(begin, end);
+    }
+
+    inline long double strto(const char* begin, char** end, long double*)
+    {
+        return std::strtold(begin, end);
+    }
+
+    template<typename T>
+    struct LexicalCast<T, typename std::enable_if<std::is_floating_point<T>::value>::type>
+    {
+        static T convert(const std::string& value)
         {
-            throw bad_lexical_cast();
+            size_t pos = value.find_first_not_of(" \t\n\v\f\r");
+            if (pos == std::string::npos 
+                || value.find_first_not_of("0123456789+-.eE", pos) != std::string::npos)
+                throw bad_lexical_cast();
+            const char* begin = value.c_str() + pos;
+            char* end = 0;
+            T t = strto(begin, &end, static_cast<T*>(0));
+            if (end == begin || *end 
+                || t == std::numeric_limits<T>::infinity() || t == -std::numeric_limits<T>::infinity())
+                throw bad_lexical_cast();
+            return t;
         }
+    };
+
+    template<typename T>
+    T lexical_cast(std::string value)
+    {
+        return LexicalCast<T>::convert(value);
+    }
+
+    // like std::istream, bool is only 0 or 1
+    template<>
+    inline bool lexical_cast<bool>(std::string value)
+    {
+        long l = LexicalCast<long>::convert(value);
+        if (l != 0 && l != 1)
+            throw bad_lexical_cast();
+        return l;
+    }
+
+    template<>
+    inline Bool lexical_cast<Bool>(std::string value)
+    {
+        return lexical_cast<bool>(value);
     }
 
     template<>
@@ -58,11 +164,32 @@ namespace CppArgParser
         return value[0];
     }
     
+    template<>
+    inline signed char lexical_cast<signed char>(std::string value)
+    {
+        if (value.size() != 1)
+            throw bad_lexical_cast();
+        return value[0];
+    }
+    
     class required_missing {};
     class too_many {};
-    class too_many_required_silent {};
     class not_enough {};
     class syntax_error {};
+
+    class duplicate_key
+    {
+    public:
+        duplicate_key(std::string key) : m_key(key) {}
+        std::string m_key;
+    };
+
+    class too_many_values
+    {
+    public:
+        too_many_values(size_t limit) : m_limit(limit) {}
+        size_t m_limit;
+    };
     
     template<typename T>
     struct ParamTraits
@@ -105,10 +232,22 @@ namespace CppArgParser
     template<typename T>
     struct ParamTraits<std::vector<T>>
     {
+        ParamTraits() : m_max_elements(0) {}
+
+        // ArgParser::limit() passes the limit
+        typedef int bounded;
+
+        void limit(size_t max_elements)
+        {
+            m_max_elements = max_elements;
+        }
+
         void convert(std::string name, std::vector<T>& v, Args& args)
         {
             if (!args.size())
                 throw required_missing();
+            if (m_max_elements && v.size() >= m_max_elements)
+                throw too_many_values(m_max_elements);
             std::string value = args[0];
             args.pop_front();
             if (value[0] == '=')
@@ -132,6 +271,9 @@ namespace CppArgParser
         {
             return -1;
         }
+
+    private:
+        size_t m_max_elements;
     };
     
     template<typename T, size_t N>
@@ -148,7 +290,7 @@ namespace CppArgParser
                 throw required_missing();
             //std::cout << "m_count: " << m_count << std::endl;
             if (m_count == N)
-                throw too_many_required_silent();
+                throw too_many();
             std::string value = args[0];
             args.pop_front();
             if (value[0] == '=')
@@ -184,11 +326,29 @@ namespace CppArgParser
     template<>
     struct ParamTraits<bool>
     {
+        // a flag takes no value on the command line, but an environment 
+        // variable always has one.  ArgParser::parse_env() passes it.
+        typedef int flag;
+
         void convert(std::string name, bool& t, Args& args)
         {
             t = true;
             return;
         }
+
+        // 1/0, true/false, yes/no (or their first letters), in any case
+        bool convert(std::string value) const
+        {
+            for (auto& c : value)
+            {
+                c = std::tolower(static_cast<unsigned char>(c));
+            }
+            if (value == "1" || value == "t" || value == "true" || value == "y" || value == "yes")
+                return true;
+            if (value == "0" || value == "f" || value == "false" || value == "n" || value == "no")
+                return false;
+            throw bad_lexical_cast();
+        }
         
         std::string value_description()
         {
@@ -205,12 +365,12 @@ namespace CppArgParser
         }
     };
 
-    struct Bool
+    inline
+    std::istream& operator>>(std::istream& is, Bool& v)
     {
-        Bool() : m_b(false) {} // HACK?
-        Bool(bool b) : m_b(b) {}
-        bool m_b;
-    };
+        is >> v.m_b;
+        return is;
+    }
     
     template<>
     struct ParamTraits<Bool>
@@ -224,26 +384,8 @@ namespace CppArgParser
             // "bool" does not allow --arg=value
             if (args.size() && args[0][0] == '=')
             {
-                std::string value = args[0].substr(1);
-                for (auto valid: m_trueValues)
-                {
-                    if (value == valid)
-                    {
-                        args.pop_front();
-                        t = true;
-                        return;
-                    }
-                }
-                for (auto valid: m_falseValues)
-                {
-                    if (value == valid)
-                    {
-                        args.pop_front();
-                        t = false;
-                        return;
-                    }
-                }
-                throw bad_lexical_cast();
+                t = convert(args[0].substr(1));
+                args.pop_front();
             }
             else
             {
@@ -252,6 +394,22 @@ namespace CppArgParser
             }
         }
 
+        // the value after "--arg="
+        Bool convert(const std::string& value) const
+        {
+            for (auto& valid: m_trueValues)
+            {
+                if (value == valid)
+                    return true;
+            }
+            for (auto& valid: m_falseValues)
+            {
+                if (value == valid)
+                    return false;
+            }
+            throw bad_lexical_cast();
+        }
+
         std::string value_description()
         {
             return "[=arg(=1)]";
@@ -270,96 +428,341 @@ namespace CppArgParser
         std::vector<std::string> m_trueValues, m_falseValues;
     };
 
-    struct Parameter
+    // the value of a map entry.  with keys_collect the values given for the
+    // same key are appended, which only a std::vector can do.
+    template<typename V>
+    struct MapValue
     {
-        std::vector<Name> m_names;
-        Name m_desc;
-        Name m_decorator;
-        size_t m_expected;
-        
-        std::string getName() const
+        static V convert(const std::string& value)
         {
-            return getName(m_names);
+            return lexical_cast<V>(value);
         }
-        
-        static std::string getName(std::vector<Name> names)
+
+        static bool collect(V& v, const std::string& value)
+        {
+            return false;
+        }
+    };
+
+    template<typename T>
+    struct MapValue<std::vector<T>>
+    {
+        static std::vector<T> convert(const std::string& value)
+        {
+            return std::vector<T>(1, lexical_cast<T>(value));
+        }
+
+        static bool collect(std::vector<T>& v, const std::string& value)
+        {
+            v.push_back(lexical_cast<T>(value));
+            return true;
+        }
+    };
+
+    template<typename Map>
+    auto reserve_entries(Map& map, size_t count, int) -> decltype(map.reserve(count), void())
+    {
+        map.reserve(count);
+    }
+
+    template<typename Map>
+    void reserve_entries(Map& map, size_t count, long)
+    {
+    }
+
+    // "key=value" entries, for std::map, std::unordered_map and FlatMap.  the
+    // entries on the command line replace the defaults with the same key.
+    template<typename Map>
+    struct MapParamTraits
+    {
+        typedef typename Map::key_type Key;
+        typedef typename Map::mapped_type Value;
+
+        // ArgParser::configure() passes the settings
+        typedef int keyed;
+
+        // ArgParser::limit() passes the limit
+        typedef int bounded;
+
+        MapParamTraits() : m_policy(keys_error), m_reserve(0), m_max_elements(0), m_map(0), m_defaults() {}
+
+        void configure(DuplicateKeys policy, size_t occurrences)
         {
-            std::string full;
-            
-            if (!names.size())
-                return full;
+            m_policy = policy;
+            m_reserve = occurrences;
+        }
 
-            for (auto nameIter = names.begin(); nameIter != names.end() - 1; ++nameIter)
+        void limit(size_t max_elements)
+        {
+            m_max_elements = max_elements;
+        }
+
+        void convert(std::string name, Map& map, Args& args)
+        {
+            if (!args.size())
+                throw required_missing();
+            std::string entry = std::move(args[0]);
+            args.pop_front();
+            size_t start = entry.size() && entry[0] == '=';
+            size_t equals = entry.find('=', start);
+            if (equals == std::string::npos)
+                throw syntax_error();
+
+            if (!m_map)
             {
-                full += *nameIter + ", ";
+                // set the defaults aside so that only the command line can repeat a key
+                m_map = &map;
+                m_defaults.swap(map);
+                size_t reserve = m_reserve + m_defaults.size();
+                if (m_max_elements)
+                    reserve = std::min(reserve, m_max_elements);
+                reserve_entries(map, reserve, 0);
             }
 
-            return full + *names.rbegin();
+            Key key = lexical_cast<Key>(entry.substr(start, equals - start));
+            std::string value = entry.substr(equals + 1);
+            auto found = map.find(key);
+            // the defaults count, as they go back in at the end
+            if (found == map.end() && m_max_elements && map.size() + m_defaults.size() >= m_max_elements)
+                throw too_many_values(m_max_elements);
+            if (found == map.end())
+                map.insert(typename Map::value_type(key, MapValue<Value>::convert(value)));
+            else if (m_policy == keys_last_wins)
+                found->second = MapValue<Value>::convert(value);
+            else if (m_policy != keys_collect || !MapValue<Value>::collect(found->second, value))
+                throw duplicate_key(entry.substr(start, equals - start));
+        }
+
+        void end()
+        {
+            if (!m_map)
+                return;
+            for (auto& entry : m_defaults)
+            {
+                m_map->insert(entry);
+            }
+        }
+
+        std::string value_description()
+        {
+            return "key=value";
+        }
+
+        size_t expected()
+        {
+            return -1;
         }
+
+    private:
+        DuplicateKeys m_policy;
+        size_t m_reserve;
+        size_t m_max_elements;
+        Map* m_map;
+        Map m_defaults;
     };
 
-    typedef std::vector<Parameter> Parameters;
+    template<typename K, typename V, typename Compare, typename Alloc>
+    struct ParamTraits<std::map<K, V, Compare, Alloc>> 
+        : MapParamTraits<std::map<K, V, Compare, Alloc>> 
+    {
+    };
 
-    class ArgParser
+    template<typename K, typename V, typename Hash, typename Equal, typename Alloc>
+    struct ParamTraits<std::unordered_map<K, V, Hash, Equal, Alloc>> 
+        : MapParamTraits<std::unordered_map<K, V, Hash, Equal, Alloc>> 
     {
-    public:
-        // if you don't supply a name then it is taken from argv[0]
-        ArgParser(int argc, char* argv[], 
-                  Name app_description = std::string(), Name app_name = std::string(), 
-                  std::ostream& os = std::cout);
-        
-        template<typename T>
-        void param(T& value, Name name, Name desc = Name(), bool visible_in_help = true);
-        
-        template<typename T>
-        void param(T& value, std::vector<Name> names, Name desc = Name(), bool visible_in_help = true);
-        
-        template<typename T>
-        T param(Name name, Name desc = Name(), bool visible_in_help = true);
+    };
 
-        template<typename T>
-        T param(std::vector<Name> names, Name desc = Name(), bool visible_in_help = true);
-        
-        bool valid();
-        
-        void print_help(Name app_name, Name app_description, std::ostream& os);
+    template<typename K, typename V, typename Hash>
+    struct ParamTraits<FlatMap<K, V, Hash>> 
+        : MapParamTraits<FlatMap<K, V, Hash>> 
+    {
+    };
+
+    struct SnapshotWriter
+    {
+        SnapshotWriter(std::string& blob) : m_blob(blob) {}
+
+        void write(const void* data, size_t size)
+        {
+            m_blob.append(static_cast<const char*>(data), size);
+        }
 
     private:
-        Name m_app_description;
-        Name m_app_name;
-        std::ostream& m_os;
-        std::stringstream m_errors;
-        Parameters m_parameters;
-        Args m_args;
-        bool m_help_requested;
-        bool m_valid;
+        std::string& m_blob;
     };
 
-    inline 
-    ArgParser::ArgParser(int argc, char* argv[], Name app_description, Name app_name, std::ostream& os)
-    :   m_app_description(app_description),
-        m_app_name(app_name),
-        m_os(os),
-        m_errors(),
-        m_parameters(),
-        m_args(),
-        m_help_requested(false),
-        m_valid(true)
+    // how a bound value is stored in a snapshot.  trivially copyable types are
+    // stored as raw bytes; anything else needs a specialization or it will not
+    // be restored from a snapshot (it is parsed normally instead).
+    template<typename T>
+    struct SnapshotTraits
     {
-        for (int argn = 0; argn < argc; argn++)
+        enum { supported = std::is_trivially_copyable<T>::value };
+
+        template<typename Out>
+        static void save(Out& out, const T& t)
         {
-            m_args.push_back(argv[argn]);
+            out.write(&t, sizeof(T));
         }
-        
-        if (!m_app_name.size())
+
+        static void load(SnapshotReader& in, T& t)
         {
-            m_app_name = m_args.front();
-            m_app_name = m_app_name.substr(m_app_name.find_last_of("\\/") + 1);
+            in.read(&t, sizeof(T));
         }
-        m_args.pop_front();
-        
-        param(m_help_requested, "--help", "show this help message", false);
-    }
+    };
+
+    template<>
+    struct SnapshotTraits<std::string>
+    {
+        enum { supported = 1 };
+
+        template<typename Out>
+        static void save(Out& out, const std::string& t)
+        {
+            uint32_t size = t.size();
+            out.write(&size, sizeof(size));
+            out.write(t.data(), size);
+        }
+
+        static void load(SnapshotReader& in, std::string& t)
+        {
+            uint32_t size = 0;
+            in.read(&size, sizeof(size));
+            if (size > size_t(in.m_end - in.m_pos))
+                throw bad_snapshot();
+            t.assign(in.m_pos, size);
+            in.m_pos += size;
+        }
+    };
+
+    template<>
+    struct SnapshotTraits<Bool>
+    {
+        enum { supported = 1 };
+
+        template<typename Out>
+        static void save(Out& out, const Bool& t)
+        {
+            SnapshotTraits<bool>::save(out, t.m_b);
+        }
+
+        static void load(SnapshotReader& in, Bool& t)
+        {
+            SnapshotTraits<bool>::load(in, t.m_b);
+        }
+    };
+
+    template<typename T>
+    struct SnapshotTraits<std::vector<T>>
+    {
+        enum { supported = SnapshotTraits<T>::supported };
+
+        template<typename Out>
+        static void save(Out& out, const std::vector<T>& v)
+        {
+            uint32_t size = v.size();
+            out.write(&size, sizeof(size));
+            for (const auto& t : v)
+                SnapshotTraits<T>::save(out, t);
+        }
+
+        static void load(SnapshotReader& in, std::vector<T>& v)
+        {
+            uint32_t size = 0;
+            in.read(&size, sizeof(size));
+            v.clear();
+            for (uint32_t i = 0; i < size; ++i)
+            {
+                T t;
+                SnapshotTraits<T>::load(in, t);
+                v.push_back(t);
+            }
+        }
+    };
+
+    template<typename T, size_t N>
+    struct SnapshotTraits<std::array<T, N>>
+    {
+        enum { supported = SnapshotTraits<T>::supported };
+
+        template<typename Out>
+        static void save(Out& out, const std::array<T, N>& v)
+        {
+            for (auto& t : v)
+                SnapshotTraits<T>::save(out, t);
+        }
+
+        static void load(SnapshotReader& in, std::array<T, N>& v)
+        {
+            for (auto& t : v)
+                SnapshotTraits<T>::load(in, t);
+        }
+    };
+
+    // maps are stored in key order, so that the same entries are always
+    // stored (and fingerprinted) the same way
+    template<typename Map>
+    struct MapSnapshotTraits
+    {
+        typedef typename Map::key_type Key;
+        typedef typename Map::mapped_type Value;
+
+        enum { supported = SnapshotTraits<Key>::supported && SnapshotTraits<Value>::supported };
+
+        template<typename Out>
+        static void save(Out& out, const Map& map)
+        {
+            std::vector<const typename Map::value_type*> entries;
+            for (auto& entry : map)
+                entries.push_back(&entry);
+            std::sort(entries.begin(), entries.end(), 
+                [](const typename Map::value_type* a, const typename Map::value_type* b)
+                {
+                    return a->first < b->first;
+                });
+            uint32_t size = entries.size();
+            out.write(&size, sizeof(size));
+            for (auto entry : entries)
+            {
+                SnapshotTraits<Key>::save(out, entry->first);
+                SnapshotTraits<Value>::save(out, entry->second);
+            }
+        }
+
+        static void load(SnapshotReader& in, Map& map)
+        {
+            uint32_t size = 0;
+            in.read(&size, sizeof(size));
+            map.clear();
+            for (uint32_t i = 0; i < size; ++i)
+            {
+                Key key;
+                Value value;
+                SnapshotTraits<Key>::load(in, key);
+                SnapshotTraits<Value>::load(in, value);
+                map.insert(typename Map::value_type(key, value));
+            }
+        }
+    };
+
+    template<typename K, typename V, typename Compare, typename Alloc>
+    struct SnapshotTraits<std::map<K, V, Compare, Alloc>> 
+        : MapSnapshotTraits<std::map<K, V, Compare, Alloc>> 
+    {
+    };
+
+    template<typename K, typename V, typename Hash, typename Equal, typename Alloc>
+    struct SnapshotTraits<std::unordered_map<K, V, Hash, Equal, Alloc>> 
+        : MapSnapshotTraits<std::unordered_map<K, V, Hash, Equal, Alloc>> 
+    {
+    };
+
+    template<typename K, typename V, typename Hash>
+    struct SnapshotTraits<FlatMap<K, V, Hash>> 
+        : MapSnapshotTraits<FlatMap<K, V, Hash>> 
+    {
+    };
 
     template<typename T>
     void ArgParser::param(T& value, Name name, Name desc, bool visible_in_help)
@@ -371,270 +774,381 @@ namespace CppArgParser
 
     template<typename T>
     void ArgParser::param(T& value, std::vector<Name> names, Name desc, bool visible_in_help)
+    {
+        add(value, names, desc, visible_in_help, true);
+    }
+
+    template<typename T>
+    void ArgParser::add(T& value, std::vector<Name> names, Name desc, bool visible_in_help, bool rebindable)
     {
         if (names.size() == 0) // TODO make sure all names are unique and non-empty
         {
-            m_errors << "every parameter must have a unique name" << std::endl;
-            m_valid = false;
+            error("every parameter must have a unique name");
         }        
+
+        ParamTraits<T> type;
+        Parameter param(names, desc, type.value_description(), type.expected(), !visible_in_help);
+        size_t index = m_parameters.size();
+        m_parameters.push_back(param);
+
+        bool positional = names.size() && names[0].size() && names[0][0] != '-';
+        if (positional)
+        {
+            // only one of them can take whatever the others leave
+            if (type.expected() == size_t(-1))
+            {
+                if (m_unbounded.size())
+                {
+                    error(Parameter::getName(names) + ": ambiguous, " 
+                          + m_unbounded + " takes all remaining values");
+                }
+                m_unbounded = Parameter::getName(names);
+            }
+        }
+
+        for (auto& name : names)
+        {
+            m_schema = hash_bytes(name.c_str(), name.size() + 1, m_schema);
+        }
+        const char* type_name = typeid(T).name();
+        m_schema = hash_bytes(type_name, std::strlen(type_name), m_schema);
+
+        if (m_restoring)
+        {
+            T original(value);
+            if (rebindable && restore(value))
+            {
+                // kept in case a later parameter does not match the snapshot
+                m_parameters[index].m_source = source_snapshot;
+                m_replay.push_back([this, &value, names, original, index, positional]()
+                {
+                    value = original;
+                    m_parameters[index].m_source = source_default;
+                    if (positional)
+                    {
+                        defer(value, index, false);
+                    }
+                    else
+                    {
+                        parse(value, names, index);
+                        hash(value, index);
+                    }
+                });
+                if (m_snapshot)
+                    record(value, *m_snapshot, m_schema);
+                hash(value, index);
+                return;
+            }
+            value = original;
+            fallback();
+        }
+
+        if (positional)
+        {
+            // positional values are handed out by valid(), once every option
+            // has taken its own.  one that is returned by value cannot wait: 
+            // it takes its value now, from what the options so far have left.
+            defer(value, index, true);
+            if (!rebindable)
+                bind_positionals();
+            return;
+        }
+        parse(value, names, index);
+        if (m_snapshot)
+            record(value, *m_snapshot, m_schema);
+        hash(value, index);
+    }
+
+    template<typename T>
+    void ArgParser::defer(T& value, size_t index, bool recorded)
+    {
+        Positional positional = { index, m_parameters[index].m_expected, std::string::npos, 0 };
+        if (recorded && m_snapshot)
+        {
+            // valid() puts the record here once there is a value
+            positional.m_record = m_snapshot->size();
+        }
+        uint64_t schema = m_schema;
+        positional.m_bind = [this, &value, index, schema](Args& values, std::string* record)
+        {
+            bind(value, index, values);
+            if (record)
+                this->record(value, *record, schema);
+            hash(value, index);
+        };
+        m_positionals.push_back(positional);
+    }
+
+    template<typename T>
+    void ArgParser::bind(T& value, size_t index, Args& values)
+    {
+        const std::vector<Name>& names = m_parameters[index].m_names;
+        size_t count = values.size();
         try
         {
             ParamTraits<T> type;
-            if (visible_in_help)
+            configure(type, names, 0);
+            limit(type, 0);
+            while (values.size())
             {
-                Parameter param = { names, desc, type.value_description(), type.expected() };
-                m_parameters.push_back(param);
+                type.convert(names[0], value, values);
             }
+            type.end();
+        }
+        catch (...)
+        {
+            conversion_error(names[0], index);
+        }
+        m_parameters[index].m_occurrences += count;
+        if (count)
+            m_parameters[index].m_source = source_argv;
+    }
+
+    template<typename T>
+    void ArgParser::parse(T& value, std::vector<Name> names, size_t index)
+    {
+        size_t occurrences = 0;
+        try
+        {
+            ParamTraits<T> type;
+            configure(type, names, 0);
+            limit(type, 0);
 
             for (auto name : names)
             {
-                Args args = m_args;
-                size_t argCount = m_args.size();
-                bool done = false;
-                for (auto argIter = m_args.begin(); argIter != m_args.end(); ++argIter)
+                // an option that is not on the command line has nothing to look for
+                if (!m_scopes.tokens(name))
+                    continue;
+                Args rest;
+                while (m_args.size() && m_valid)
                 {
-                    if (!m_valid || done) 
-                        break;
-                    std::string arg;
+                    std::string arg = std::move(m_args.front());
+                    m_args.pop_front();
                     try
                     {
-                        arg = *argIter;
-                        //std::cout << "ARG: " << arg;
-                        //std::cout << "  args:[";
-                        //for (auto argIter2 = m_args.begin(); argIter2 != m_args.end(); ++argIter2)
-                        //{
-                        //    std::cout <<*argIter2 << ", ";
-                        //}
-                        //std::cout << "]" << std::endl;
                         if (arg == name)
                         {
-                            // "--param value" for optional params
-                            //   "param value" for required params (TODO: don't support this)
-                            args.pop_front();
-                            type.convert(name, value, args);
+                            // "--param value"
+                            occurrences++;
+                            type.convert(name, value, m_args);
                         }
                         else if (arg.size() > name.size() 
-                            && arg.substr(0, name.size()) == name
+                            && arg.compare(0, name.size(), name) == 0
                             && arg[name.size()] == '=')
                         {
-                            // "--opt-param=value" for optional params
-                            //       "param=value" for required params (TODO: maybe keep this?)
-                            args[0] = arg.substr(name.size());
-                            type.convert(name, value, args);
-                        }
-                        else if (name.size() && name[0] != '-' 
-                            && args.size() && args[0].size()
-                            && args[0][0] != '-')
-                        {
-                            // "value" (for required params)
-                            type.convert(name, value, args);
-                        }
-                    }
-                    catch (bad_lexical_cast&)
-                    {
-                        m_errors << name << " failed conversion" << std::endl;
-                        m_valid = false;
-                    }
-                    catch (required_missing&)
-                    {
-                        m_errors << name << " is required" << std::endl;
-                        m_valid = false;
-                    }
-                    catch (too_many&)
-                    {
-                        m_errors << Parameter::getName(names) << ": too many instances" << std::endl;
-                        m_valid = false;
-                    }
-                    catch (too_many_required_silent&)
-                    {
-                        if (names[0][0] == '-')
-                        {
-                            m_errors << Parameter::getName(names) << ": too many instances" << std::endl;
-                            m_valid = false;
+                            // "--param=value"
+                            m_args.push_front(arg.substr(name.size()));
+                            occurrences++;
+                            type.convert(name, value, m_args);
                         }
                         else
                         {
-                            // give someone else a chance to look at this argument
-                            //args.push_front(arg);
-                            //std::cout << "BLAH" << std::endl;
-                            m_args = args;
-                            return;
-                            done = true;
-                            break;
+                            rest.push_back(std::move(arg));
                         }
                     }
-                    catch (not_enough&)
+                    catch (...)
                     {
-                        m_errors << Parameter::getName(names) << ": not enough instances" << std::endl;
-                        m_valid = false;
-                    }
-                    catch (syntax_error&)
-                    {
-                        m_errors << Parameter::getName(names) << ": syntax error" << std::endl;
-                        m_valid = false;
+                        conversion_error(name, index);
                     }
                 }
-                m_args = args;
+
+                // keep whatever was not taken in its original order
+                std::move(m_args.begin(), m_args.end(), std::back_inserter(rest));
+                m_args.swap(rest);
             }
+
             type.end();
         }
         catch (not_enough&)
         {
-            m_errors << Parameter::getName(names) << ": not enough instances" << std::endl;
-            m_valid = false;
+            error(Parameter::getName(names) + ": not enough instances");
+        }
+
+        m_parameters[index].m_occurrences += occurrences;
+        if (occurrences)
+        {
+            m_parameters[index].m_source = source_argv;
+        }
+        else if (m_env.size())
+        {
+            parse_env(value, names, index);
+        }
+    }
+
+    template<typename T>
+    void ArgParser::parse_env(T& value, std::vector<Name> names, size_t index)
+    {
+        for (auto& name : names)
+        {
+            if (!name.size() || name[0] != '-')
+                continue;
+            auto found = m_env.find(m_env_mangle(name));
+            if (found == m_env.end())
+                continue;
+
+            // "PREFIX_NAME=value" is treated like "--name=value"
+            Name var = m_env_prefix + found->first;
+            m_parameters[index].m_source = source_env;
+            try
+            {
+                ParamTraits<T> type;
+                configure(type, names, 0);
+                limit(type, 0);
+                convert_env(type, var, value, found->second, 0);
+                type.end();
+            }
+            catch (bad_lexical_cast&)
+            {
+                m_parameters[index].m_failures++;
+                error(var + " failed conversion");
+            }
+            catch (not_enough&)
+            {
+                error(var + ": not enough instances");
+            }
+            catch (syntax_error&)
+            {
+                error(var + ": syntax error");
+            }
+            catch (too_many_values& e)
+            {
+                error(var + ": more than " + std::to_string(e.m_limit) + " values");
+            }
+            return;
         }
     }
 
     template<typename T>
     T ArgParser::param(Name name, Name desc, bool visible_in_help)
     {
-        T t;
-        param(t, name, desc, visible_in_help);
-        return t;
+        std::vector<Name> names;
+        names.push_back(name);
+        return param<T>(names, desc, visible_in_help);
     }
 
     template<typename T>
     T ArgParser::param(std::vector<Name> names, Name desc, bool visible_in_help)
     {
-        T t;
-        param(t, names, desc, visible_in_help);
+        // a value returned by value cannot be re-parsed if the snapshot turns
+        // out not to match later on, so it is never taken from the snapshot
+        T t = T();
+        add(t, names, desc, visible_in_help, false);
         return t;
     }
 
-    inline
-    bool ArgParser::valid()
+    template<typename T>
+    bool ArgParser::restore(T& value)
     {
-        if (m_help_requested)
-        {
-            print_help(m_app_name, m_app_description, m_os);
+        if (!SnapshotTraits<T>::supported)
             return false;
-        }
-
-        for (auto& arg : m_args)
+        try
         {
-            m_errors << "ArgParser unknown name " << "\"" << arg << "\"" << std::endl;
-            m_valid = false;
+            SnapshotRecord record;
+            m_restore.read(&record, sizeof(record));
+            if (record.m_schema != m_schema || (record.m_flags & snapshot_unsupported)
+                || record.m_size > size_t(m_restore.m_end - m_restore.m_pos))
+                return false;
+            SnapshotReader in(m_restore.m_pos, m_restore.m_pos + record.m_size);
+            SnapshotTraits<T>::load(in, value);
+            if (in.m_pos != in.m_end)
+                return false;
+            m_restore.m_pos = in.m_end;
+            return true;
         }
-        
-        if (!m_valid)
+        catch (bad_snapshot&)
         {
-            // show only the first error for now
-            std::string errors = m_errors.str();
-            auto eol = errors.find('\n');
-            if (eol != std::string::npos)
-                errors = errors.substr(0, eol + 1);
-            throw std::runtime_error(errors);
+            return false;
         }
-
-        return m_valid;
     }
 
-    inline
-    void ArgParser::print_help(Name app_name, Name app_description, std::ostream& os)
+    template<typename T>
+    void ArgParser::record(const T& value, std::string& snapshot, uint64_t schema)
     {
-        Parameters optional;
-        Parameters required;
-        
-        std::vector<std::string> aliases;
-        aliases.push_back("--help");
-        Parameter param = {aliases, "show this help message", ""};
-        m_parameters.push_back(param);
-        
-        os << "Usage: " << app_name; 
-        for (auto param: m_parameters)
+        SnapshotRecord record = { schema, 0, 0 };
+        size_t offset = snapshot.size();
+        snapshot.append(reinterpret_cast<const char*>(&record), sizeof(record));
+        if (SnapshotTraits<T>::supported)
         {
-            auto name = param.getName();
-            if (name.size() && name[0] == '-')
-            {
-                optional.push_back(param);
-            }
-            else
-            {
-                os << " <" << name << ">";
-                if (param.m_expected > 1)
-                {
-                    if (param.m_expected < 4)
-                    {
-                        for (int i = 1; i < param.m_expected; ++i)
-                        {
-                            os << " <" << name << ">";
-                        }
-                    }
-                    else
-                    {
-                        os << "*";
-                        if (param.m_expected == -1)
-                            os << "n";
-                        else
-                            os << param.m_expected;
-                    }
-                }
-                required.push_back(param);
-            }
-        }        
-        if (optional.size())
-            os << " [options]";
-        os << std::endl;
-        os << std::endl;
-        
-        if (app_description.size())
+            SnapshotWriter out(snapshot);
+            SnapshotTraits<T>::save(out, value);
+        }
+        else
         {
-            os << app_description << std::endl;
-            os << std::endl;
+            record.m_flags = snapshot_unsupported;
         }
+        record.m_size = snapshot.size() - offset - sizeof(record);
+        std::memcpy(&snapshot[offset], &record, sizeof(record));
+        m_snapshot_count++;
+    }
 
-        if (required.size())
+    template<typename T>
+    void ArgParser::hash(const T& value, size_t index)
+    {
+        const std::vector<Name>& names = m_parameters[index].m_names;
+        for (auto& name : names)
         {
-            os << "Required parameters:" << std::endl;
-            for (auto param: required)
-            {
-                os << "  " << param.getName() << ": " << param.m_desc << std::endl;
-            }
+            if (std::find(m_fingerprint_excluded.begin(), m_fingerprint_excluded.end(), name) 
+                != m_fingerprint_excluded.end())
+                return;
         }
-
-        if (optional.size())
+        if (!SnapshotTraits<T>::supported)
         {
-            os << "Optional parameters:" << std::endl;
-            int max = 0;
-            for (auto param: optional)
-            {
-                // get the decorator (HACKY)
-                std::string decorator = param.m_decorator;
-                int cur = param.getName().size() + 1 + decorator.size();
-                if (max < cur)
-                    max = cur;
-            }
-            for (auto param: optional)
-            {
-                std::string decorator = param.m_decorator;
-                decorator = param.getName() + " " + decorator;
-                os << "  " << std::left << std::setw(max + 2) << decorator << param.m_desc << std::endl;
-            }
-            os << std::endl;
+            m_fingerprint_complete = false;
+            return;
         }
+        // the name keeps values from running into each other
+        Hash128 hash;
+        Name name = Parameter::getName(names);
+        hash.write(name.c_str(), name.size() + 1);
+        SnapshotTraits<T>::save(hash, value);
+        if (m_hashes.size() <= index)
+            m_hashes.resize(index + 1, Fingerprint());
+        m_hashes[index] = hash.finish();
     }
 
-    inline
-    ParamTraits<CppArgParser::Bool>::ParamTraits()
-    {
-        m_trueValues.push_back("1");
-        m_trueValues.push_back("T");
-        m_trueValues.push_back("True");
-        m_trueValues.push_back("Y");
-        m_trueValues.push_back("Yes");
-        m_falseValues.push_back("0");
-        m_falseValues.push_back("F");
-        m_falseValues.push_back("False");
-        m_falseValues.push_back("N");
-        m_falseValues.push_back("No");
+    template<typename Traits>
+    void ArgParser::configure(Traits& type, const std::vector<Name>& names, typename Traits::keyed*)
+    {
+        type.configure(m_duplicate_keys, occurrences(names));
+    }
+
+    template<typename Traits>
+    void ArgParser::configure(Traits& type, const std::vector<Name>& names, ...)
+    {
+    }
+
+    template<typename Traits, typename T>
+    void ArgParser::convert_env(Traits& type, const Name& var, T& value, const Name& env_value, 
+                                typename Traits::flag*)
+    {
+        value = type.convert(env_value);
+    }
+
+    template<typename Traits, typename T>
+    void ArgParser::convert_env(Traits& type, const Name& var, T& value, const Name& env_value, ...)
+    {
+        Args args;
+        args.push_back("=" + env_value);
+        type.convert(var, value, args);
+    }
+
+    template<typename Traits>
+    void ArgParser::limit(Traits& type, typename Traits::bounded*)
+    {
+        type.limit(m_limits.m_max_elements);
+    }
+
+    template<typename Traits>
+    void ArgParser::limit(Traits& type, ...)
+    {
     }
 
 };// namespace CppArgParser
 
-inline
-std::istream& operator>>(std::istream& is, CppArgParser::Bool& v)
-{
-    is >> v.m_b;
-    return is;
-}        
-        
+// with CPPARGPARSER_LIBRARY the non-template parts and the built-in types
+// come from the CppArgParser library, otherwise everything is inline.
+#ifdef CPPARGPARSER_LIBRARY
+#include "ArgParserLib.h"
+#else
+#include "ArgParserImpl.h"
+#endif
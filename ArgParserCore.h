@@ -0,0 +1,823 @@
+#pragma once
+#include <string>
+#include <deque>
+#include <array>
+#include <vector>
+#include <map>
+#include <bitset>
+#include <functional>
+#include <unordered_map>
+#include <iosfwd>
+#include <cstdio>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+// the declarations shared by the header-only ArgParser.h and the compiled
+// library (ArgParserLib.h).  non-template functions are inline unless they
+// come from the library.
+#ifndef CPPARGPARSER_INLINE
+#define CPPARGPARSER_INLINE inline
+#endif
+
+namespace CppArgParser
+{
+    
+    typedef std::string Name;
+    typedef std::deque<std::string> Args;
+        
+    struct Bool
+    {
+        Bool() : m_b(false) {} // HACK?
+        Bool(bool b) : m_b(b) {}
+        bool m_b;
+    };
+
+    class bad_snapshot {};
+
+    // FNV-1a, used for the snapshot schema hash
+    inline uint64_t hash_bytes(const void* data, size_t size, uint64_t hash = 14695981039346656037ULL)
+    {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i)
+        {
+            hash ^= bytes[i];
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    // a 128-bit configuration fingerprint, see ArgParser::fingerprint()
+    struct Fingerprint
+    {
+        uint64_t m_low;
+        uint64_t m_high;
+
+        bool operator==(const Fingerprint& other) const
+        {
+            return m_low == other.m_low && m_high == other.m_high;
+        }
+
+        bool operator!=(const Fingerprint& other) const
+        {
+            return !(*this == other);
+        }
+
+        // 32 hex digits, high half first
+        std::string hex() const
+        {
+            std::string hex(32, '0');
+            for (int digit = 0; digit < 16; ++digit)
+            {
+                hex[15 - digit] = "0123456789abcdef"[(m_high >> (digit * 4)) & 15];
+                hex[31 - digit] = "0123456789abcdef"[(m_low >> (digit * 4)) & 15];
+            }
+            return hex;
+        }
+    };
+
+    // MurmurHash3 x64_128 (Austin Appleby, public domain), fed a piece at a
+    // time.  it has the write() of a snapshot writer so values can be hashed
+    // with SnapshotTraits<T>::save().
+    class Hash128
+    {
+    public:
+        Hash128() : m_h1(0), m_h2(0), m_length(0), m_tail_size(0) {}
+
+        void write(const void* data, size_t size)
+        {
+            const unsigned char* bytes = static_cast<const unsigned char*>(data);
+            m_length += size;
+            if (m_tail_size)
+            {
+                size_t fill = std::min(size, sizeof(m_tail) - m_tail_size);
+                std::memcpy(m_tail + m_tail_size, bytes, fill);
+                m_tail_size += fill;
+                bytes += fill;
+                size -= fill;
+                if (m_tail_size < sizeof(m_tail))
+                    return;
+                block(m_tail);
+                m_tail_size = 0;
+            }
+            for (; size >= sizeof(m_tail); bytes += sizeof(m_tail), size -= sizeof(m_tail))
+            {
+                block(bytes);
+            }
+            std::memcpy(m_tail, bytes, size);
+            m_tail_size = size;
+        }
+
+        Fingerprint finish() const
+        {
+            uint64_t h1 = m_h1;
+            uint64_t h2 = m_h2;
+            uint64_t k1 = 0;
+            uint64_t k2 = 0;
+            for (size_t i = m_tail_size; i > 8; --i)
+            {
+                k2 |= uint64_t(m_tail[i - 1]) << ((i - 9) * 8);
+            }
+            for (size_t i = std::min(m_tail_size, size_t(8)); i > 0; --i)
+            {
+                k1 |= uint64_t(m_tail[i - 1]) << ((i - 1) * 8);
+            }
+            if (m_tail_size > 8)
+                h2 ^= rotl(k2 * c2, 33) * c1;
+            if (m_tail_size)
+                h1 ^= rotl(k1 * c1, 31) * c2;
+
+            h1 ^= m_length;
+            h2 ^= m_length;
+            h1 += h2;
+            h2 += h1;
+            h1 = fmix(h1);
+            h2 = fmix(h2);
+            h1 += h2;
+            h2 += h1;
+            Fingerprint fingerprint = { h1, h2 };
+            return fingerprint;
+        }
+
+    private:
+        static const uint64_t c1 = 0x87c37b91114253d5ULL;
+        static const uint64_t c2 = 0x4cf5ad432745937fULL;
+
+        static uint64_t rotl(uint64_t x, int r)
+        {
+            return (x << r) | (x >> (64 - r));
+        }
+
+        static uint64_t fmix(uint64_t k)
+        {
+            k ^= k >> 33;
+            k *= 0xff51afd7ed558ccdULL;
+            k ^= k >> 33;
+            k *= 0xc4ceb9fe1a85ec53ULL;
+            k ^= k >> 33;
+            return k;
+        }
+
+        void block(const unsigned char* bytes)
+        {
+            uint64_t k1;
+            uint64_t k2;
+            std::memcpy(&k1, bytes, sizeof(k1));
+            std::memcpy(&k2, bytes + sizeof(k1), sizeof(k2));
+            m_h1 ^= rotl(k1 * c1, 31) * c2;
+            m_h1 = (rotl(m_h1, 27) + m_h2) * 5 + 0x52dce729;
+            m_h2 ^= rotl(k2 * c2, 33) * c1;
+            m_h2 = (rotl(m_h2, 31) + m_h1) * 5 + 0x38495ab5;
+        }
+
+        uint64_t m_h1;
+        uint64_t m_h2;
+        uint64_t m_length;
+        unsigned char m_tail[16];
+        size_t m_tail_size;
+    };
+
+    struct SnapshotReader
+    {
+        SnapshotReader(const char* begin, const char* end) : m_pos(begin), m_end(end) {}
+
+        void read(void* data, size_t size)
+        {
+            if (size > size_t(m_end - m_pos))
+                throw bad_snapshot();
+            std::memcpy(data, m_pos, size);
+            m_pos += size;
+        }
+
+        const char* m_pos;
+        const char* m_end;
+    };
+
+    // snapshot blob layout (native byte order, offsets only, no pointers):
+    //   SnapshotHeader
+    //   SnapshotRecord + value bytes, one per parameter in registration order
+    struct SnapshotHeader
+    {
+        char m_magic[4];        // "CAPS"
+        uint32_t m_version;
+        uint64_t m_schema;      // schema hash after the last parameter
+        uint32_t m_count;       // number of records
+        uint32_t m_size;        // bytes following the header
+    };
+
+    struct SnapshotRecord
+    {
+        uint64_t m_schema;      // schema hash up to and including this parameter
+        uint32_t m_size;        // bytes of value data following the record
+        uint32_t m_flags;       // snapshot_unsupported if the value was not stored
+    };
+
+    enum
+    {
+        snapshot_version = 1,
+        snapshot_unsupported = 1
+    };
+
+    // where help text goes.  a function pointer and its context rather than a
+    // std::ostream, so that printing help does not need iostreams.
+    struct Sink
+    {
+        typedef void (*Write)(void* context, const char* data, size_t size);
+
+        Sink(Write write, void* context) : m_write(write), m_context(context) {}
+
+        void write(const std::string& text) const
+        {
+            m_write(m_context, text.data(), text.size());
+        }
+
+        Write m_write;
+        void* m_context;
+    };
+
+    // a sink for a C stream, e.g. stdout (which std::cout is synchronized with)
+    CPPARGPARSER_INLINE Sink file_sink(std::FILE* file);
+
+    // a sink that calls write(2) on a file descriptor, without any buffering
+    CPPARGPARSER_INLINE Sink fd_sink(int fd);
+
+    // a sink for a std::ostream, which must outlive it
+    CPPARGPARSER_INLINE Sink ostream_sink(std::ostream& os);
+
+    // telemetry file layout (native byte order), appended once per valid():
+    //   TelemetryHeader
+    //   TelemetryRecord + name bytes, one per parameter in registration order
+    // or, when records did not fit in the buffer, a TelemetryHeader alone with
+    // m_result telemetry_dropped and m_count the number of records dropped.
+    struct TelemetryHeader
+    {
+        char m_magic[4];        // "CAPT"
+        uint32_t m_size;        // bytes following the header
+        uint64_t m_schema;      // the snapshot schema hash
+        uint32_t m_count;       // number of records
+        uint32_t m_result;      // telemetry_valid, telemetry_help, telemetry_error or telemetry_dropped
+    };
+
+    struct TelemetryRecord
+    {
+        uint32_t m_occurrences;
+        uint32_t m_failures;
+        uint16_t m_name_size;   // bytes of Parameter::getName() following the record
+        uint8_t m_source;
+        uint8_t m_flags;        // telemetry_hidden
+    };
+
+    enum
+    {
+        telemetry_valid,
+        telemetry_help,
+        telemetry_error,
+        telemetry_dropped
+    };
+
+    // TelemetryRecord::m_flags
+    enum
+    {
+        telemetry_hidden = 1    // not shown by --help
+    };
+
+    // what a map parameter does when the command line gives a key twice
+    enum DuplicateKeys
+    {
+        keys_error,             // report an error
+        keys_last_wins,         // keep the last value
+        keys_collect            // append to the value, which must be a std::vector
+    };
+
+    // the arguments left for a child process: a piece of the original argv,
+    // followed by its terminating null pointer, so it can go to execv() as is
+    struct Passthrough
+    {
+        int m_argc;
+        char** m_argv;
+    };
+
+    // hard limits on the work a parse does, for command lines that are not 
+    // trusted.  each is checked before anything is allocated for what would 
+    // exceed it, and zero means no limit.
+    struct Limits
+    {
+        Limits() : m_max_tokens(0), m_max_value_bytes(0), m_max_elements(0), m_max_errors(0) {}
+
+        size_t m_max_tokens;        // arguments, not counting argv[0] or a passthrough
+        size_t m_max_value_bytes;   // bytes in one value (or option name)
+        size_t m_max_elements;      // values in one vector or map parameter
+        size_t m_max_errors;        // errors kept, the rest are counted
+    };
+
+    // opt in to usage telemetry: from now on every ArgParser::valid() in this
+    // process appends a record of its parameters to path.  records are 
+    // buffered without locking and written at exit; TelemetryAgg sums them up.
+    CPPARGPARSER_INLINE bool telemetry(const char* path);
+
+    // write the records buffered so far.  the buffer holds 64 KiB of them and
+    // counts the ones that do not fit as dropped, so a long-running process 
+    // calls this now and then (it does not hold up the parses meanwhile).
+    CPPARGPARSER_INLINE void telemetry_flush();
+
+    // default environment variable name for a parameter: "--max-conn" -> "MAX_CONN"
+    CPPARGPARSER_INLINE Name env_name(Name name);
+
+    // where the value of a parameter came from, for telemetry()
+    enum Source
+    {
+        source_default,
+        source_argv,
+        source_env,
+        source_snapshot
+    };
+
+    struct Parameter
+    {
+        Parameter(std::vector<Name> names, Name desc, Name decorator, size_t expected = 0, bool hidden = false)
+            : m_names(names), m_desc(desc), m_decorator(decorator), m_expected(expected), m_hidden(hidden),
+              m_source(source_default), m_occurrences(0), m_failures(0)
+        {
+        }
+
+        std::vector<Name> m_names;
+        Name m_desc;
+        Name m_decorator;
+        size_t m_expected;
+        bool m_hidden;              // not shown by --help
+        uint8_t m_source;           // Source
+        uint32_t m_occurrences;     // times it was on the command line
+        uint32_t m_failures;        // values that failed conversion
+        
+        std::string getName() const
+        {
+            return getName(m_names);
+        }
+        
+        static std::string getName(std::vector<Name> names)
+        {
+            std::string full;
+            
+            if (!names.size())
+                return full;
+
+            for (auto nameIter = names.begin(); nameIter != names.end() - 1; ++nameIter)
+            {
+                full += *nameIter + ", ";
+            }
+
+            return full + *names.rbegin();
+        }
+    };
+
+    typedef std::vector<Parameter> Parameters;
+
+    // the option names on the command line split at the dots, one node per
+    // segment: "--db.pool.size" is "--db" -> "pool" -> "size".  a parameter
+    // walks its name down the tree to see if it was given before it looks
+    // through the arguments, and stops at the first segment nobody used.
+    class ScopeTree
+    {
+    public:
+        struct Node
+        {
+            Node() : m_children(), m_tokens(0) {}
+
+            std::map<Name, size_t> m_children;
+            uint32_t m_tokens;                  // arguments with this name
+        };
+
+        ScopeTree() : m_nodes(1) {}
+
+        // an argument on the command line, by its name (up to any "=")
+        void add_token(const Name& name);
+
+        // the arguments with this name
+        uint32_t tokens(const Name& name) const;
+
+    private:
+        std::vector<Node> m_nodes;
+    };
+
+    // a set of parameters, one bit per index into ArgParser's parameters, so
+    // that a constraint over any number of them is a few word operations
+    class ParamSet
+    {
+    public:
+        ParamSet(size_t size = 0) : m_words((size + 63) / 64) {}
+
+        void insert(size_t index)
+        {
+            m_words[index / 64] |= uint64_t(1) << (index % 64);
+        }
+
+        bool intersects(const ParamSet& other) const
+        {
+            for (size_t word = 0; word < m_words.size(); ++word)
+            {
+                if (m_words[word] & other.m_words[word])
+                    return true;
+            }
+            return false;
+        }
+
+        // other is a subset of this
+        bool includes(const ParamSet& other) const
+        {
+            for (size_t word = 0; word < m_words.size(); ++word)
+            {
+                if (other.m_words[word] & ~m_words[word])
+                    return false;
+            }
+            return true;
+        }
+
+        // the number of parameters in both
+        size_t common(const ParamSet& other) const
+        {
+            size_t count = 0;
+            for (size_t word = 0; word < m_words.size(); ++word)
+            {
+                count += std::bitset<64>(m_words[word] & other.m_words[word]).count();
+            }
+            return count;
+        }
+
+    private:
+        std::vector<uint64_t> m_words;
+    };
+
+    enum ConstraintKind
+    {
+        constraint_require,     // if the first is given, so are the others
+        constraint_conflict,    // at most one is given
+        constraint_one_of       // at least one is given
+    };
+
+    struct Constraint
+    {
+        Constraint(ConstraintKind kind, std::vector<Name> names)
+            : m_kind(kind), m_names(names), m_first(), m_all(), m_unknown()
+        {
+        }
+
+        ConstraintKind m_kind;
+        std::vector<Name> m_names;
+        // compiled by ArgParser::compile_constraints()
+        ParamSet m_first;       // the first parameter on its own
+        ParamSet m_all;         // all of them
+        Name m_unknown;         // a name that is not a parameter, if any
+    };
+
+    // a positional parameter, waiting for valid() to hand out its values
+    struct Positional
+    {
+        size_t m_index;         // into the parameters
+        size_t m_arity;         // values it takes, size_t(-1) for all that are left
+        size_t m_record;        // where its snapshot record goes, or npos
+        std::function<void(Args& values, std::string* record)> m_bind;
+    };
+
+    class Scope;
+
+    class ArgParser
+    {
+    public:
+        // if you don't supply a name then it is taken from argv[0].
+        // help is printed to stdout unless another sink (or stream) is given.
+        ArgParser(int argc, char* argv[], 
+                  Name app_description = std::string(), Name app_name = std::string(),
+                  Sink sink = file_sink(stdout), Limits limits = Limits());
+        ArgParser(int argc, char* argv[], Name app_description, Name app_name, std::ostream& os,
+                  Limits limits = Limits());
+        ~ArgParser();
+        
+        template<typename T>
+        void param(T& value, Name name, Name desc = Name(), bool visible_in_help = true);
+        
+        template<typename T>
+        void param(T& value, std::vector<Name> names, Name desc = Name(), bool visible_in_help = true);
+        
+        // a positional parameter returned by value takes its values right 
+        // away, from what the options added before it have left
+        template<typename T>
+        T param(Name name, Name desc = Name(), bool visible_in_help = true);
+
+        template<typename T>
+        T param(std::vector<Name> names, Name desc = Name(), bool visible_in_help = true);
+        
+        bool valid();
+        
+        void print_help(Name app_name, Name app_description, Sink sink);
+
+        void print_help(Name app_name, Name app_description, std::ostream& os);
+
+        // record the values of the parameters added after this call into blob.
+        // the blob is only usable once valid() has succeeded.
+        void snapshot_to(std::string& blob);
+
+        // bind the parameters added after this call from a blob written by
+        // snapshot_to() instead of parsing the command line.  data must stay
+        // valid until valid() returns.  if the parameters do not match the ones
+        // that were recorded, the command line is parsed normally instead.
+        void snapshot_from(const char* data, size_t size);
+
+        // fill the options added after this call that are not on the command 
+        // line from the environment variable prefix + mangle(name), if set.
+        // the environment is only scanned once, here.
+        void env(Name prefix, std::function<Name(Name)> mangle = env_name);
+
+        // a hash of the values of the parameters, in the order they were added,
+        // so that the same configuration gets the same fingerprint however it
+        // was spelled on the command line.  it is built up as the parameters
+        // are added and is complete once valid() succeeds.  parameters whose 
+        // type has no SnapshotTraits make it zero unless they are excluded.
+        Fingerprint fingerprint() const;
+
+        // leave a parameter out of fingerprint(), by any of its names.  this
+        // must be called before the parameter is added.
+        void fingerprint_exclude(Name name);
+
+        // how the map parameters added after this call treat a key that is
+        // given twice.  the default is keys_error.
+        void duplicate_keys(DuplicateKeys policy);
+
+        // let "--" end the options instead of being an unknown name.  with
+        // at_positional, the first positional that no parameter takes ends
+        // them as well.  the arguments after that are in passthrough().
+        void allow_passthrough(bool at_positional = false);
+
+        // the arguments after the end of the options, once valid() succeeded.
+        // they point into the argv given to the constructor.
+        Passthrough passthrough() const;
+
+        // constraints between parameters, by any of their names, checked by 
+        // valid() once the rest of the command line is.  a parameter counts as
+        // given if it was on the command line or in the environment.  they can
+        // be declared before or after the parameters they name.
+        void require(Name name, std::vector<Name> required);
+
+        void conflict(std::vector<Name> names);
+
+        void one_of(std::vector<Name> names);
+
+        // the parameters named "--path.*", for a module that owns them
+        Scope scope(Name path);
+
+        // add every parameter declared with CPPARGPARSER_PARAM in any translation 
+        // unit, ordered by name.  this can only be done once per process.
+        void param_registry();
+
+    private:
+        friend class Scope;
+
+        template<typename T>
+        void add(T& value, std::vector<Name> names, Name desc, bool visible_in_help, bool rebindable);
+
+        template<typename T>
+        void parse(T& value, std::vector<Name> names, size_t index);
+
+        template<typename T>
+        void parse_env(T& value, std::vector<Name> names, size_t index);
+
+        template<typename T>
+        bool restore(T& value);
+
+        template<typename T>
+        void record(const T& value, std::string& snapshot, uint64_t schema);
+
+        // keep a positional parameter for valid()
+        template<typename T>
+        void defer(T& value, size_t index, bool recorded);
+
+        // convert the values valid() handed out to a positional parameter
+        template<typename T>
+        void bind(T& value, size_t index, Args& values);
+
+        // hand out the positional values by arity, then convert them
+        void bind_positionals();
+
+        // report the exception being handled, from converting a value of 
+        // the parameter at index given as name
+        void conversion_error(const Name& name, size_t index);
+
+        template<typename T>
+        void hash(const T& value, size_t index);
+
+        // pass the settings to the ParamTraits that take them
+        template<typename Traits>
+        void configure(Traits& type, const std::vector<Name>& names, typename Traits::keyed*);
+
+        template<typename Traits>
+        void configure(Traits& type, const std::vector<Name>& names, ...);
+
+        // convert an environment variable's value, which a flag has to read
+        template<typename Traits, typename T>
+        void convert_env(Traits& type, const Name& var, T& value, const Name& env_value, 
+                         typename Traits::flag*);
+
+        template<typename Traits, typename T>
+        void convert_env(Traits& type, const Name& var, T& value, const Name& env_value, ...);
+
+        // pass the limits to the ParamTraits that grow
+        template<typename Traits>
+        void limit(Traits& type, typename Traits::bounded*);
+
+        template<typename Traits>
+        void limit(Traits& type, ...);
+
+        size_t occurrences(const std::vector<Name>& names);
+
+        void fallback();
+
+        bool too_long(const char* arg) const;
+
+        void error(Name message);
+
+        void report(uint32_t result);
+
+        Name suggest(const Name& arg) const;
+
+        void compile_constraints();
+
+        void check_constraints();
+
+        Name help(Name app_name, Name app_description, const Parameters& parameters) const;
+
+        Name m_app_description;
+        Name m_app_name;
+        int m_argc;
+        char** m_argv;
+        int m_terminator;           // index of "--" in argv, or argc
+        int m_passthrough;          // index of the first argument passed through
+        bool m_passthrough_allowed;
+        bool m_passthrough_positional;
+        Sink m_sink;
+        std::string m_errors;
+        size_t m_error_count;
+        Parameters m_parameters;
+        Args m_args;
+        bool m_help_requested;
+        bool m_valid;
+        uint64_t m_schema;
+        std::string* m_snapshot;
+        uint32_t m_snapshot_count;
+        bool m_restoring;
+        SnapshotReader m_restore;
+        uint64_t m_restore_schema;
+        Args m_restore_args;
+        std::vector<std::function<void()>> m_replay;
+        Name m_env_prefix;
+        std::function<Name(Name)> m_env_mangle;
+        std::unordered_map<Name, Name> m_env;
+        Name m_unbounded;
+        std::vector<Positional> m_positionals;
+        std::vector<Fingerprint> m_hashes;  // per parameter, zero if left out
+        bool m_fingerprint_complete;
+        std::vector<Name> m_fingerprint_excluded;
+        bool m_restore_fingerprint_complete;
+        DuplicateKeys m_duplicate_keys;
+        ScopeTree m_scopes;
+        Limits m_limits;
+        std::vector<Constraint> m_constraints;
+        size_t m_constraints_compiled;  // the parameter count the masks are for
+    };
+
+    // the parameters under one dotted prefix, for a module that owns them:
+    //     Scope pool = args.scope("db.pool");
+    //     pool.param(size, "size", "connections");     // --db.pool.size
+    // names in a scope are given without the dashes.
+    class Scope
+    {
+    public:
+        Scope(ArgParser& args, Name path)
+        :   m_args(args),
+            m_path(path)
+        {
+        }
+
+        template<typename T>
+        void param(T& value, Name name, Name desc = Name(), bool visible_in_help = true)
+        {
+            m_args.param(value, full_name(name), desc, visible_in_help);
+        }
+
+        template<typename T>
+        T param(Name name, Name desc = Name(), bool visible_in_help = true)
+        {
+            return m_args.param<T>(full_name(name), desc, visible_in_help);
+        }
+
+        // a scope below this one
+        Scope scope(Name path) const
+        {
+            return Scope(m_args, m_path.size() ? m_path + "." + path : path);
+        }
+
+        // the option name of name in this scope
+        Name full_name(Name name) const
+        {
+            return m_path.size() ? "--" + m_path + "." + name : "--" + name;
+        }
+
+        const Name& path() const
+        {
+            return m_path;
+        }
+
+        // the help for the parameters in this scope and below
+        void print_help(Sink sink = file_sink(stdout)) const;
+
+        void print_help(std::ostream& os) const;
+
+    private:
+        ArgParser& m_args;
+        Name m_path;
+    };
+
+    // a parameter declared with CPPARGPARSER_PARAM.  registering only links it
+    // into a list whose head is constant-initialized, so it does not depend on
+    // the order in which translation units are initialized.
+    class Registered
+    {
+    public:
+        Registered(const char* name, const char* desc)
+        :   m_name(name),
+            m_desc(desc),
+            m_next(head())
+        {
+            head() = this;
+        }
+
+        virtual void bind(ArgParser& args) = 0;
+
+        static Registered*& head()
+        {
+            static Registered* head = 0;
+            return head;
+        }
+
+        static bool& frozen()
+        {
+            static bool frozen = false;
+            return frozen;
+        }
+
+        const char* m_name;
+        const char* m_desc;
+        Registered* m_next;
+
+    protected:
+        ~Registered() {}
+    };
+
+    // the value is only written by ArgParser::param_registry(), so once the
+    // command line is parsed it can be read from any thread.
+    template<typename T>
+    class RegisteredParam : public Registered
+    {
+    public:
+        RegisteredParam(const char* name, const char* desc, T value = T())
+        :   Registered(name, desc),
+            m_value(value)
+        {
+        }
+
+        const T& get() const
+        {
+            return m_value;
+        }
+
+        const T& operator*() const
+        {
+            return m_value;
+        }
+
+        const T* operator->() const
+        {
+            return &m_value;
+        }
+
+    private:
+        void bind(ArgParser& args)
+        {
+            args.param(m_value, m_name, m_desc);
+        }
+
+        T m_value;
+    };
+
+};// namespace CppArgParser
+
+// declare a parameter next to the code that uses it, at namespace scope:
+//     CPPARGPARSER_PARAM(int, max_conn, "--max-conn", "connection limit", 10);
+// and read it with *max_conn once ArgParser::param_registry() and valid() are done.
+#define CPPARGPARSER_PARAM(type, ident, name, desc, value) \
+    CppArgParser::RegisteredParam<type> ident(name, desc, value)
+
+// make a parameter declared in another translation unit visible in this one
+#define CPPARGPARSER_DECLARE(type, ident) \
+    extern CppArgParser::RegisteredParam<type> ident
+        
+        
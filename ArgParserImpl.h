@@ -0,0 +1,1207 @@
+#pragma once
+// the non-template parts of ArgParser, included by ArgParser.h when it is
+// used header-only and compiled once into the CppArgParser library otherwise
+#include "ArgParser.h"
+#include <string>
+#include <vector>
+#include <ostream>
+#include <stdexcept>
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+#include <cerrno>
+#include <unistd.h>
+#include <fcntl.h>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <array>
+#include <cstdlib>
+
+extern char** environ;
+
+namespace CppArgParser
+{
+
+    CPPARGPARSER_INLINE
+    Sink file_sink(std::FILE* file)
+    {
+        return Sink([](void* context, const char* data, size_t size)
+        {
+            std::fwrite(data, 1, size, static_cast<std::FILE*>(context));
+        }, file);
+    }
+
+    CPPARGPARSER_INLINE
+    Sink fd_sink(int fd)
+    {
+        return Sink([](void* context, const char* data, size_t size)
+        {
+            int fd = int(reinterpret_cast<intptr_t>(context));
+            while (size)
+            {
+                ssize_t written = ::write(fd, data, size);
+                if (written < 0 && errno == EINTR)
+                    continue;
+                if (written <= 0)
+                    return;
+                data += written;
+                size -= written;
+            }
+        }, reinterpret_cast<void*>(intptr_t(fd)));
+    }
+
+    CPPARGPARSER_INLINE
+    Sink ostream_sink(std::ostream& os)
+    {
+        return Sink([](void* context, const char* data, size_t size)
+        {
+            static_cast<std::ostream*>(context)->write(data, size).flush();
+        }, &os);
+    }
+
+    // the telemetry file and the records not written to it yet, in two 
+    // buffers: parses append to one while a flush writes the other.  a parse 
+    // reserves its space with one compare-and-swap; records that do not fit
+    // are dropped and counted.  a flush swaps the buffers, waits for the 
+    // parses still copying into the one it took and writes it out, at exit,
+    // on telemetry_flush() or when telemetry() opens another file.
+    struct TelemetryBuffer
+    {
+        enum { capacity = 1 << 16 };
+
+        struct Half
+        {
+            Half() : m_reserved(0), m_dropped(0), m_writers(0) {}
+
+            std::atomic<size_t> m_reserved;
+            std::atomic<size_t> m_dropped;
+            std::atomic<size_t> m_writers;  // parses copying a record in
+            char m_data[capacity];
+        };
+
+        TelemetryBuffer() : m_fd(-1), m_pid(0), m_active(0), m_flushing(), m_halves() {}
+
+        void append(const std::string& record)
+        {
+            if (m_pid != getpid())
+            {
+                // a forked child does not write its parent's records again
+                m_pid = getpid();
+                reset(m_halves[0]);
+                reset(m_halves[1]);
+            }
+            Half* half = 0;
+            for (;;)
+            {
+                unsigned active = m_active.load();
+                half = &m_halves[active];
+                half->m_writers.fetch_add(1);
+                // a flush that swapped in between would not wait for this one
+                if (m_active.load() == active)
+                    break;
+                half->m_writers.fetch_sub(1);
+            }
+            size_t pos = half->m_reserved.load();
+            do
+            {
+                if (pos + record.size() > capacity)
+                {
+                    half->m_dropped.fetch_add(1);
+                    half->m_writers.fetch_sub(1);
+                    return;
+                }
+            }
+            while (!half->m_reserved.compare_exchange_weak(pos, pos + record.size()));
+            std::memcpy(half->m_data + pos, record.data(), record.size());
+            half->m_writers.fetch_sub(1);
+        }
+
+        void flush()
+        {
+            std::lock_guard<std::mutex> lock(m_flushing);
+            if (m_pid != getpid())
+                return;
+            unsigned active = m_active.load();
+            Half& half = m_halves[active];
+            m_active.store(1 - active);
+            while (half.m_writers.load())
+            {
+                std::this_thread::yield();
+            }
+
+            write(half.m_data, half.m_reserved.load());
+            size_t dropped = half.m_dropped.load();
+            if (dropped)
+            {
+                TelemetryHeader header = { { 'C', 'A', 'P', 'T' }, 0, 0, uint32_t(dropped), telemetry_dropped };
+                write(reinterpret_cast<const char*>(&header), sizeof(header));
+            }
+            reset(half);
+        }
+
+        static void reset(Half& half)
+        {
+            half.m_reserved = 0;
+            half.m_dropped = 0;
+            half.m_writers = 0;
+        }
+
+        void write(const char* data, size_t size)
+        {
+            // O_APPEND keeps records from several processes whole
+            while (size)
+            {
+                ssize_t written = ::write(m_fd, data, size);
+                if (written < 0 && errno == EINTR)
+                    continue;
+                if (written <= 0)
+                    return;
+                data += written;
+                size -= written;
+            }
+        }
+
+        std::atomic<int> m_fd;
+        pid_t m_pid;
+        std::atomic<unsigned> m_active;     // the half parses append to
+        std::mutex m_flushing;
+        Half m_halves[2];
+    };
+
+    CPPARGPARSER_INLINE
+    TelemetryBuffer& telemetry_buffer()
+    {
+        static TelemetryBuffer buffer;
+        return buffer;
+    }
+
+    CPPARGPARSER_INLINE
+    bool telemetry(const char* path)
+    {
+        TelemetryBuffer& buffer = telemetry_buffer();
+        int fd = ::open(path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (fd < 0)
+            return false;
+        if (buffer.m_fd < 0)
+        {
+            std::atexit([]()
+            {
+                telemetry_buffer().flush();
+            });
+        }
+        else
+        {
+            buffer.flush();
+            ::close(buffer.m_fd);
+        }
+        buffer.m_pid = getpid();
+        buffer.m_fd = fd;
+        return true;
+    }
+
+    CPPARGPARSER_INLINE
+    void telemetry_flush()
+    {
+        TelemetryBuffer& buffer = telemetry_buffer();
+        if (buffer.m_fd >= 0)
+            buffer.flush();
+    }
+
+    CPPARGPARSER_INLINE
+    Name env_name(Name name)
+    {
+        Name env;
+        size_t start = name.find_first_not_of('-');
+        if (start == Name::npos)
+            start = name.size();
+        for (auto c : name.substr(start))
+        {
+            if (c >= 'a' && c <= 'z')
+                env += c - 'a' + 'A';
+            else if ((c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9'))
+                env += c;
+            else
+                env += '_';
+        }
+        return env;
+    }
+
+    CPPARGPARSER_INLINE
+    ArgParser::ArgParser(int argc, char* argv[], Name app_description, Name app_name, Sink sink, Limits limits)
+    :   m_app_description(app_description),
+        m_app_name(app_name),
+        m_argc(argc),
+        m_argv(argv),
+        m_terminator(argc),
+        m_passthrough(argc),
+        m_passthrough_allowed(false),
+        m_passthrough_positional(false),
+        m_sink(sink),
+        m_errors(),
+        m_error_count(0),
+        m_parameters(),
+        m_args(),
+        m_help_requested(false),
+        m_valid(true),
+        m_schema(hash_bytes(0, 0)),
+        m_snapshot(0),
+        m_snapshot_count(0),
+        m_restoring(false),
+        m_restore(0, 0),
+        m_restore_schema(0),
+        m_restore_args(),
+        m_replay(),
+        m_env_prefix(),
+        m_env_mangle(),
+        m_env(),
+        m_unbounded(),
+        m_positionals(),
+        m_hashes(),
+        m_fingerprint_complete(true),
+        m_fingerprint_excluded(),
+        m_restore_fingerprint_complete(true),
+        m_duplicate_keys(keys_error),
+        m_scopes(),
+        m_limits(limits),
+        m_constraints(),
+        m_constraints_compiled(Name::npos)
+    {
+        for (int argn = 0; argn < argc; argn++)
+        {
+            // nothing after "--" is parsed
+            if (argn && !std::strcmp(argv[argn], "--"))
+            {
+                m_terminator = argn;
+                m_passthrough = argn + 1;
+                break;
+            }
+            // nothing past a limit is copied, or looked at
+            if (argn && m_limits.m_max_tokens && size_t(argn) > m_limits.m_max_tokens)
+            {
+                error("ArgParser more than " + std::to_string(m_limits.m_max_tokens) + " arguments");
+                break;
+            }
+            if (argn && m_limits.m_max_value_bytes && too_long(argv[argn]))
+            {
+                error("ArgParser argument " + std::to_string(argn) + " is longer than " 
+                      + std::to_string(m_limits.m_max_value_bytes) + " bytes");
+                break;
+            }
+            m_args.push_back(argv[argn]);
+        }
+        
+        if (!m_app_name.size())
+        {
+            m_app_name = m_args.front();
+            m_app_name = m_app_name.substr(m_app_name.find_last_of("\\/") + 1);
+        }
+        m_args.pop_front();
+
+        for (auto& arg : m_args)
+        {
+            if (arg.size() && arg[0] == '-')
+                m_scopes.add_token(arg.substr(0, arg.find('=')));
+        }
+        
+        param(m_help_requested, "--help", "show this help message", false);
+    }
+
+    CPPARGPARSER_INLINE
+    ArgParser::ArgParser(int argc, char* argv[], Name app_description, Name app_name, std::ostream& os,
+                         Limits limits)
+    :   ArgParser(argc, argv, app_description, app_name, ostream_sink(os), limits)
+    {
+    }
+
+    CPPARGPARSER_INLINE
+    ArgParser::~ArgParser()
+    {
+    }
+
+    CPPARGPARSER_INLINE
+    void ArgParser::snapshot_to(std::string& blob)
+    {
+        m_snapshot = &blob;
+        m_snapshot_count = 0;
+        // the header is filled in by valid()
+        blob.assign(sizeof(SnapshotHeader), '\0');
+    }
+
+    CPPARGPARSER_INLINE
+    void ArgParser::snapshot_from(const char* data, size_t size)
+    {
+        SnapshotHeader header;
+        if (size < sizeof(header))
+            return;
+        std::memcpy(&header, data, sizeof(header));
+        if (std::memcmp(header.m_magic, "CAPS", sizeof(header.m_magic))
+            || header.m_version != snapshot_version
+            || header.m_size != size - sizeof(header))
+            return;
+        m_restore = SnapshotReader(data + sizeof(header), data + size);
+        m_restore_schema = header.m_schema;
+        m_restore_fingerprint_complete = m_fingerprint_complete;
+        m_restoring = true;
+        m_restore_args.swap(m_args);
+    }
+
+    CPPARGPARSER_INLINE
+    void ArgParser::env(Name prefix, std::function<Name(Name)> mangle)
+    {
+        m_env_prefix = prefix;
+        m_env_mangle = mangle;
+        m_env.clear();
+        for (char** var = environ; var && *var; ++var)
+        {
+            const char* entry = *var;
+            if (std::strncmp(entry, prefix.c_str(), prefix.size()))
+                continue;
+            const char* equals = std::strchr(entry, '=');
+            if (!equals || equals < entry + prefix.size())
+                continue;
+            m_env[Name(entry + prefix.size(), equals)] = Name(equals + 1);
+        }
+    }
+
+    CPPARGPARSER_INLINE
+    Fingerprint ArgParser::fingerprint() const
+    {
+        if (!m_fingerprint_complete)
+        {
+            Fingerprint none = { 0, 0 };
+            return none;
+        }
+        // each value was hashed on its own, as positional ones are bound last
+        Hash128 hash;
+        for (auto& value : m_hashes)
+        {
+            if (value != Fingerprint())
+                hash.write(&value, sizeof(value));
+        }
+        return hash.finish();
+    }
+
+    CPPARGPARSER_INLINE
+    void ArgParser::fingerprint_exclude(Name name)
+    {
+        for (auto& param : m_parameters)
+        {
+            for (auto& added : param.m_names)
+            {
+                if (added == name)
+                {
+                    error(name + ": excluded from the fingerprint after it was added");
+                    return;
+                }
+            }
+        }
+        m_fingerprint_excluded.push_back(name);
+    }
+
+    CPPARGPARSER_INLINE
+    void ArgParser::duplicate_keys(DuplicateKeys policy)
+    {
+        m_duplicate_keys = policy;
+    }
+
+    CPPARGPARSER_INLINE
+    size_t ArgParser::occurrences(const std::vector<Name>& names)
+    {
+        size_t count = 0;
+        for (auto& arg : m_args)
+        {
+            for (auto& name : names)
+            {
+                if (arg.compare(0, name.size(), name) == 0 
+                    && (arg.size() == name.size() || arg[name.size()] == '='))
+                    count++;
+            }
+        }
+        return count;
+    }
+
+    CPPARGPARSER_INLINE
+    void ArgParser::allow_passthrough(bool at_positional)
+    {
+        m_passthrough_allowed = true;
+        m_passthrough_positional = at_positional;
+    }
+
+    CPPARGPARSER_INLINE
+    Passthrough ArgParser::passthrough() const
+    {
+        Passthrough passthrough = { m_argc - m_passthrough, m_argv + m_passthrough };
+        return passthrough;
+    }
+
+    CPPARGPARSER_INLINE
+    void ArgParser::param_registry()
+    {
+        if (Registered::frozen())
+        {
+            error("ArgParser registered parameters were already parsed");
+            return;
+        }
+        Registered::frozen() = true;
+
+        std::vector<Registered*> registry;
+        for (Registered* param = Registered::head(); param; param = param->m_next)
+        {
+            registry.push_back(param);
+        }
+        std::sort(registry.begin(), registry.end(), [](Registered* a, Registered* b)
+        {
+            return std::strcmp(a->m_name, b->m_name) < 0;
+        });
+        for (auto param : registry)
+        {
+            param->bind(*this);
+        }
+    }
+
+    // the name and the value of "--name=value" are limited on their own, so 
+    // that long option names do not eat into the values
+    CPPARGPARSER_INLINE
+    bool ArgParser::too_long(const char* arg) const
+    {
+        size_t max = m_limits.m_max_value_bytes;
+        size_t size = strnlen(arg, max + 1);
+        if (size <= max)
+            return false;
+        const char* equals = arg[0] == '-' ? static_cast<const char*>(std::memchr(arg, '=', size)) : 0;
+        return !equals || strnlen(equals + 1, max + 1) > max;
+    }
+
+    CPPARGPARSER_INLINE
+    void ArgParser::error(Name message)
+    {
+        m_valid = false;
+        // past the limit only the fact that there were more is kept
+        if (m_limits.m_max_errors && m_error_count >= m_limits.m_max_errors)
+        {
+            if (m_error_count++ == m_limits.m_max_errors)
+                m_errors += "ArgParser more than " + std::to_string(m_limits.m_max_errors) + " errors\n";
+            return;
+        }
+        m_error_count++;
+        m_errors += message + "\n";
+    }
+
+    CPPARGPARSER_INLINE
+    void ArgParser::report(uint32_t result)
+    {
+        TelemetryBuffer& buffer = telemetry_buffer();
+        if (buffer.m_fd < 0)
+            return;
+
+        std::string records(sizeof(TelemetryHeader), '\0');
+        uint32_t count = 0;
+        for (auto& param : m_parameters)
+        {
+            Name name = param.getName();
+            TelemetryRecord record = { param.m_occurrences, param.m_failures, uint16_t(name.size()), 
+                                       param.m_source, uint8_t(param.m_hidden ? telemetry_hidden : 0) };
+            records.append(reinterpret_cast<const char*>(&record), sizeof(record));
+            records.append(name, 0, record.m_name_size);
+            count++;
+        }
+        TelemetryHeader header = { { 'C', 'A', 'P', 'T' }, uint32_t(records.size() - sizeof(header)), 
+                                   m_schema, count, result };
+        std::memcpy(&records[0], &header, sizeof(header));
+        buffer.append(records);
+    }
+
+    // the Levenshtein distance from a pattern of up to 64 characters to other
+    // strings, with Myers' bit-parallel algorithm (in Hyyro's formulation for
+    // whole strings): one pass of a few word operations per character.
+    class EditDistance
+    {
+    public:
+        enum { max_pattern = 64 };
+
+        EditDistance(const Name& pattern)
+        :   m_size(pattern.size()),
+            m_peq(),
+            m_histogram()
+        {
+            for (size_t i = 0; i < m_size; ++i)
+            {
+                unsigned char c = pattern[i];
+                m_peq[c] |= uint64_t(1) << i;
+                m_histogram[c]++;
+            }
+        }
+
+        // a lower bound on the distance from the characters alone: each edit
+        // changes the character counts by at most two
+        size_t lower_bound(const Name& text)
+        {
+            size_t different = m_size;
+            for (unsigned char c : text)
+            {
+                if (m_histogram[c]-- > 0)
+                    different--;
+                else
+                    different++;
+            }
+            for (unsigned char c : text)
+            {
+                m_histogram[c]++;
+            }
+            return (different + 1) / 2;
+        }
+
+        size_t distance(const Name& text) const
+        {
+            if (!m_size)
+                return text.size();
+            uint64_t high = uint64_t(1) << (m_size - 1);
+            uint64_t pv = (high << 1) - 1;
+            uint64_t mv = 0;
+            size_t score = m_size;
+            for (unsigned char c : text)
+            {
+                uint64_t eq = m_peq[c];
+                uint64_t xv = eq | mv;
+                uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+                uint64_t ph = mv | ~(xh | pv);
+                uint64_t mh = pv & xh;
+                if (ph & high)
+                    score++;
+                else if (mh & high)
+                    score--;
+                ph = (ph << 1) | 1;
+                mh <<= 1;
+                pv = mh | ~(xv | ph);
+                mv = ph & xv;
+            }
+            return score;
+        }
+
+    private:
+        size_t m_size;
+        std::array<uint64_t, 256> m_peq;
+        std::array<int, 256> m_histogram;
+    };
+
+    // the closest parameter name to an unknown option, or nothing if none is
+    // close.  only called for the unknown names, so a good parse never pays.
+    CPPARGPARSER_INLINE
+    Name ArgParser::suggest(const Name& arg) const
+    {
+        Name option = arg.substr(0, arg.find('='));
+        size_t dashes = option.find_first_not_of('-');
+        if (!dashes || dashes == Name::npos || option.size() > EditDistance::max_pattern)
+            return Name();
+        // allow one edit for every three characters of the name
+        size_t limit = (option.size() - dashes) / 3;
+        if (!limit)
+            return Name();
+
+        EditDistance pattern(option);
+        Name best;
+        size_t best_distance = limit + 1;
+        for (auto& param : m_parameters)
+        {
+            // do not give hidden parameters away
+            if (param.m_hidden)
+                continue;
+            for (auto& name : param.m_names)
+            {
+                if (name.size() + limit < option.size() || option.size() + limit < name.size())
+                    continue;
+                if (pattern.lower_bound(name) >= best_distance)
+                    continue;
+                size_t distance = pattern.distance(name);
+                if (distance < best_distance)
+                {
+                    best = name;
+                    best_distance = distance;
+                }
+            }
+        }
+        return best;
+    }
+
+    CPPARGPARSER_INLINE
+    void ArgParser::require(Name name, std::vector<Name> required)
+    {
+        required.insert(required.begin(), name);
+        m_constraints.push_back(Constraint(constraint_require, required));
+        m_constraints_compiled = Name::npos;
+    }
+
+    CPPARGPARSER_INLINE
+    void ArgParser::conflict(std::vector<Name> names)
+    {
+        m_constraints.push_back(Constraint(constraint_conflict, names));
+        m_constraints_compiled = Name::npos;
+    }
+
+    CPPARGPARSER_INLINE
+    void ArgParser::one_of(std::vector<Name> names)
+    {
+        m_constraints.push_back(Constraint(constraint_one_of, names));
+        m_constraints_compiled = Name::npos;
+    }
+
+    // resolve the names of the constraints to masks over the parameters, once
+    // for as long as no parameter or constraint is added
+    CPPARGPARSER_INLINE
+    void ArgParser::compile_constraints()
+    {
+        std::unordered_map<Name, size_t> indices;
+        for (size_t index = 0; index < m_parameters.size(); ++index)
+        {
+            for (auto& name : m_parameters[index].m_names)
+            {
+                indices.emplace(name, index);
+            }
+        }
+
+        for (auto& constraint : m_constraints)
+        {
+            constraint.m_first = ParamSet(m_parameters.size());
+            constraint.m_all = ParamSet(m_parameters.size());
+            constraint.m_unknown.clear();
+            for (auto& name : constraint.m_names)
+            {
+                auto found = indices.find(name);
+                if (found == indices.end())
+                {
+                    constraint.m_unknown = name;
+                    break;
+                }
+                if (&name == &constraint.m_names.front())
+                    constraint.m_first.insert(found->second);
+                constraint.m_all.insert(found->second);
+            }
+        }
+        m_constraints_compiled = m_parameters.size();
+    }
+
+    CPPARGPARSER_INLINE
+    void ArgParser::check_constraints()
+    {
+        if (m_constraints_compiled != m_parameters.size())
+            compile_constraints();
+
+        ParamSet given(m_parameters.size());
+        // the values bound from a snapshot were checked where it was taken
+        ParamSet restored(m_parameters.size());
+        for (size_t index = 0; index < m_parameters.size(); ++index)
+        {
+            const Parameter& param = m_parameters[index];
+            if (param.m_source == source_argv || param.m_source == source_env)
+                given.insert(index);
+            else if (param.m_source == source_snapshot)
+                restored.insert(index);
+        }
+
+        for (auto& constraint : m_constraints)
+        {
+            if (constraint.m_unknown.size())
+            {
+                error("ArgParser constraint on unknown name \"" + constraint.m_unknown + "\"");
+                continue;
+            }
+            if (constraint.m_all.intersects(restored))
+                continue;
+
+            switch (constraint.m_kind)
+            {
+            case constraint_require:
+                if (given.intersects(constraint.m_first) && !given.includes(constraint.m_all))
+                {
+                    std::vector<Name> required(constraint.m_names.begin() + 1, constraint.m_names.end());
+                    error(constraint.m_names[0] + " requires " + Parameter::getName(required));
+                }
+                break;
+            case constraint_conflict:
+                if (given.common(constraint.m_all) > 1)
+                    error(Parameter::getName(constraint.m_names) + ": only one can be given");
+                break;
+            case constraint_one_of:
+                if (!given.intersects(constraint.m_all))
+                    error(Parameter::getName(constraint.m_names) + ": one is required");
+                break;
+            }
+        }
+    }
+
+    CPPARGPARSER_INLINE
+    void ArgParser::conversion_error(const Name& name, size_t index)
+    {
+        Name full = m_parameters[index].getName();
+        try
+        {
+            throw;
+        }
+        catch (bad_lexical_cast&)
+        {
+            m_parameters[index].m_failures++;
+            error(name + " failed conversion");
+        }
+        catch (required_missing&)
+        {
+            error(name + " is required");
+        }
+        catch (too_many&)
+        {
+            error(full + ": too many instances");
+        }
+        catch (not_enough&)
+        {
+            error(full + ": not enough instances");
+        }
+        catch (syntax_error&)
+        {
+            error(full + ": syntax error");
+        }
+        catch (duplicate_key& e)
+        {
+            error(full + ": duplicate key \"" + e.m_key + "\"");
+        }
+        catch (too_many_values& e)
+        {
+            error(full + ": more than " + std::to_string(e.m_limit) + " values");
+        }
+    }
+
+    // the options have taken their values by now, so what is left that does 
+    // not start with "-" is for the positional parameters.  those given by
+    // name ("name=value" or "name value") are set aside first, then the rest
+    // are handed out in order: each bounded parameter gets what it still 
+    // takes, and the unbounded one, wherever it is, gets what they leave.
+    CPPARGPARSER_INLINE
+    void ArgParser::bind_positionals()
+    {
+        const size_t left = size_t(-1);
+        const size_t unnamed = size_t(-2);
+        size_t count = m_positionals.size();
+
+        std::unordered_map<Name, size_t> names;
+        for (size_t positional = 0; positional < count; ++positional)
+        {
+            for (auto& name : m_parameters[m_positionals[positional].m_index].m_names)
+            {
+                names.emplace(name, positional);
+            }
+        }
+
+        // who each argument goes to, and how many each one got by name
+        std::vector<size_t> owners(m_args.size(), left);
+        std::vector<size_t> given(count, 0);
+        std::vector<bool> missing(count, false);
+        size_t unnamed_count = 0;
+        for (size_t arg = 0; arg < m_args.size(); ++arg)
+        {
+            const Name& token = m_args[arg];
+            if (!token.size() || token[0] == '-')
+                continue;
+            auto found = names.find(token.substr(0, token.find('=')));
+            if (found == names.end())
+            {
+                owners[arg] = unnamed;
+                unnamed_count++;
+            }
+            else if (token.size() > found->first.size())
+            {
+                owners[arg] = found->second;
+                given[found->second]++;
+            }
+            else if (arg + 1 < m_args.size())
+            {
+                owners[arg] = owners[arg + 1] = found->second;
+                given[found->second]++;
+                arg++;
+            }
+            else
+            {
+                owners[arg] = found->second;
+                missing[found->second] = true;
+            }
+        }
+
+        // how many unnamed values each one takes
+        std::vector<size_t> takes(count, 0);
+        size_t bounded = 0;
+        size_t unbounded = count;
+        for (size_t positional = 0; positional < count; ++positional)
+        {
+            size_t arity = m_positionals[positional].m_arity;
+            if (arity == size_t(-1))
+                unbounded = positional;
+            else if (given[positional] < arity)
+                takes[positional] = arity - given[positional];
+            bounded += takes[positional];
+        }
+        if (unbounded < count && unnamed_count > bounded)
+            takes[unbounded] = unnamed_count - bounded;
+
+        // hand them out in order; what nobody takes is left for valid()
+        std::vector<Args> values(count);
+        Args rest;
+        size_t next = 0;
+        for (size_t arg = 0; arg < m_args.size(); ++arg)
+        {
+            size_t owner = owners[arg];
+            if (owner == unnamed)
+            {
+                while (next < count && !takes[next])
+                    next++;
+                if (next < count)
+                {
+                    takes[next]--;
+                    values[next].push_back(std::move(m_args[arg]));
+                    continue;
+                }
+            }
+            else if (owner != left)
+            {
+                const Name& token = m_args[arg];
+                size_t equals = token.find('=');
+                if (equals != Name::npos)
+                    values[owner].push_back(token.substr(equals));
+                else if (!missing[owner])
+                    values[owner].push_back(std::move(m_args[++arg]));
+                continue;
+            }
+            rest.push_back(std::move(m_args[arg]));
+        }
+        m_args.swap(rest);
+
+        // only now is anything converted
+        size_t shift = 0;
+        for (size_t positional = 0; positional < count && m_valid; ++positional)
+        {
+            Positional& param = m_positionals[positional];
+            Name name = m_parameters[param.m_index].getName();
+            if (missing[positional])
+            {
+                error(m_parameters[param.m_index].m_names[0] + " is required");
+            }
+            else if (param.m_arity != size_t(-1) && given[positional] > param.m_arity)
+            {
+                error(name + ": too many instances");
+            }
+            else if (param.m_arity != size_t(-1) && values[positional].size() < param.m_arity)
+            {
+                error(name + ": not enough instances");
+            }
+            else if (param.m_record != std::string::npos)
+            {
+                std::string record;
+                param.m_bind(values[positional], &record);
+                m_snapshot->insert(param.m_record + shift, record);
+                shift += record.size();
+            }
+            else
+            {
+                param.m_bind(values[positional], 0);
+            }
+        }
+        m_positionals.clear();
+    }
+
+    CPPARGPARSER_INLINE
+    void ArgParser::fallback()
+    {
+        // the snapshot does not match: parse the command line after all, 
+        // starting over with the parameters already bound from the snapshot
+        m_restoring = false;
+        m_args.swap(m_restore_args);
+        m_fingerprint_complete = m_restore_fingerprint_complete;
+        std::vector<std::function<void()>> replay;
+        replay.swap(m_replay);
+        for (auto& bind : replay)
+        {
+            bind();
+        }
+    }
+
+    CPPARGPARSER_INLINE
+    bool ArgParser::valid()
+    {
+        if (m_restoring)
+        {
+            // the recorded schema had more (or other) parameters than this one
+            if (m_restore.m_pos != m_restore.m_end || m_restore_schema != m_schema)
+                fallback();
+            m_restoring = false;
+            m_replay.clear();
+        }
+
+        if (m_help_requested)
+        {
+            report(telemetry_help);
+            print_help(m_app_name, m_app_description, m_sink);
+            return false;
+        }
+
+        if (m_valid && m_positionals.size())
+        {
+            bind_positionals();
+        }
+
+        if (m_passthrough_positional)
+        {
+            // the first positional that is left starts the passthrough
+            auto first = std::find_if(m_args.begin(), m_args.end(), [](const std::string& arg)
+            {
+                return !arg.size() || arg[0] != '-';
+            });
+            if (first != m_args.end())
+            {
+                // it and everything after it are still there, unless an option took
+                // one of them.  then the command line is ambiguous without "--".
+                int count = m_args.end() - first;
+                int start = m_terminator - count;
+                bool untouched = start > 0 && std::equal(first, m_args.end(), m_argv + start);
+                if (untouched)
+                {
+                    m_passthrough = start;
+                    m_args.erase(first, m_args.end());
+                }
+                else
+                {
+                    error("ArgParser options after \"" + *first + "\" were parsed, end the options with --");
+                }
+            }
+        }
+
+        for (auto& arg : m_args)
+        {
+            if (m_limits.m_max_errors && m_error_count > m_limits.m_max_errors)
+                break;
+            Name suggestion = suggest(arg);
+            if (suggestion.size())
+                error("ArgParser unknown name \"" + arg + "\" (did you mean \"" + suggestion + "\"?)");
+            else
+                error("ArgParser unknown name \"" + arg + "\"");
+        }
+
+        if (!m_passthrough_allowed && m_terminator < m_argc)
+        {
+            error("ArgParser unknown name \"--\"");
+        }
+
+        // what was given is only known if everything else was parsed
+        if (m_valid && m_constraints.size())
+        {
+            check_constraints();
+        }
+        
+        report(m_valid ? telemetry_valid : telemetry_error);
+
+        if (!m_valid)
+        {
+            // show only the first error for now
+            std::string errors = m_errors;
+            auto eol = errors.find('\n');
+            if (eol != std::string::npos)
+                errors = errors.substr(0, eol + 1);
+            throw std::runtime_error(errors);
+        }
+
+        if (m_snapshot)
+        {
+            SnapshotHeader header = { { 'C', 'A', 'P', 'S' }, snapshot_version, m_schema, 
+                                      m_snapshot_count, uint32_t(m_snapshot->size() - sizeof(header)) };
+            std::memcpy(&(*m_snapshot)[0], &header, sizeof(header));
+        }
+
+        return m_valid;
+    }
+
+    CPPARGPARSER_INLINE
+    void ArgParser::print_help(Name app_name, Name app_description, Sink sink)
+    {
+        std::vector<std::string> aliases;
+        aliases.push_back("--help");
+        Parameter param(aliases, "show this help message", "");
+        Parameters parameters = m_parameters;
+        parameters.push_back(param);
+
+        sink.write(help(app_name, app_description, parameters));
+    }
+
+    CPPARGPARSER_INLINE
+    Name ArgParser::help(Name app_name, Name app_description, const Parameters& parameters) const
+    {
+        std::string help;
+        Parameters optional;
+        Parameters required;
+        
+        help += "Usage: " + app_name;
+        for (auto param: parameters)
+        {
+            if (param.m_hidden)
+                continue;
+            auto name = param.getName();
+            if (name.size() && name[0] == '-')
+            {
+                optional.push_back(param);
+            }
+            else
+            {
+                help += " <" + name + ">";
+                if (param.m_expected == size_t(-1))
+                {
+                    help += "...";
+                }
+                else if (param.m_expected > 1)
+                {
+                    if (param.m_expected < 4)
+                    {
+                        for (size_t i = 1; i < param.m_expected; ++i)
+                        {
+                            help += " <" + name + ">";
+                        }
+                    }
+                    else
+                    {
+                        help += "*" + std::to_string(param.m_expected);
+                    }
+                }
+                required.push_back(param);
+            }
+        }        
+        if (optional.size())
+            help += " [options]";
+        help += "\n";
+        help += "\n";
+        
+        if (app_description.size())
+        {
+            help += app_description + "\n";
+            help += "\n";
+        }
+
+        if (required.size())
+        {
+            help += "Required parameters:\n";
+            for (auto param: required)
+            {
+                help += "  " + param.getName() + ": " + param.m_desc + "\n";
+            }
+        }
+
+        if (optional.size())
+        {
+            help += "Optional parameters:\n";
+            int max = 0;
+            for (auto param: optional)
+            {
+                // get the decorator (HACKY)
+                std::string decorator = param.m_decorator;
+                int cur = param.getName().size() + 1 + decorator.size();
+                if (max < cur)
+                    max = cur;
+            }
+            for (auto param: optional)
+            {
+                std::string decorator = param.m_decorator;
+                decorator = param.getName() + " " + decorator;
+                if (decorator.size() < size_t(max + 2))
+                    decorator.resize(max + 2, ' ');
+                help += "  " + decorator + param.m_desc + "\n";
+            }
+            help += "\n";
+        }
+
+        return help;
+    }
+
+    CPPARGPARSER_INLINE
+    void ArgParser::print_help(Name app_name, Name app_description, std::ostream& os)
+    {
+        print_help(app_name, app_description, ostream_sink(os));
+    }
+
+    CPPARGPARSER_INLINE
+    Scope ArgParser::scope(Name path)
+    {
+        return Scope(*this, path);
+    }
+
+    CPPARGPARSER_INLINE
+    void Scope::print_help(Sink sink) const
+    {
+        Name prefix = full_name("");
+        Parameters parameters;
+        for (auto& param : m_args.m_parameters)
+        {
+            for (auto& name : param.m_names)
+            {
+                if (name.compare(0, prefix.size(), prefix) == 0 || name + "." == prefix)
+                {
+                    parameters.push_back(param);
+                    break;
+                }
+            }
+        }
+        Name description = m_path.size() ? "The --" + m_path + " parameters" : "";
+        sink.write(m_args.help(m_args.m_app_name, description, parameters));
+    }
+
+    CPPARGPARSER_INLINE
+    void Scope::print_help(std::ostream& os) const
+    {
+        print_help(ostream_sink(os));
+    }
+
+    CPPARGPARSER_INLINE
+    void ScopeTree::add_token(const Name& name)
+    {
+        size_t node = 0;
+        size_t begin = 0;
+        while (begin <= name.size())
+        {
+            size_t end = std::min(name.find('.', begin), name.size());
+            auto found = m_nodes[node].m_children.emplace(name.substr(begin, end - begin), m_nodes.size());
+            if (found.second)
+                m_nodes.push_back(Node());
+            node = found.first->second;
+            begin = end + 1;
+        }
+        m_nodes[node].m_tokens++;
+    }
+
+    CPPARGPARSER_INLINE
+    uint32_t ScopeTree::tokens(const Name& name) const
+    {
+        size_t node = 0;
+        size_t begin = 0;
+        Name segment;
+        while (begin <= name.size())
+        {
+            size_t end = std::min(name.find('.', begin), name.size());
+            segment.assign(name, begin, end - begin);
+            auto& children = m_nodes[node].m_children;
+            auto found = children.find(segment);
+            if (found == children.end())
+                return 0;
+            node = found->second;
+            begin = end + 1;
+        }
+        return m_nodes[node].m_tokens;
+    }
+
+    CPPARGPARSER_INLINE
+    ParamTraits<CppArgParser::Bool>::ParamTraits()
+    {
+        m_trueValues.push_back("1");
+        m_trueValues.push_back("T");
+        m_trueValues.push_back("True");
+        m_trueValues.push_back("Y");
+        m_trueValues.push_back("Yes");
+        m_falseValues.push_back("0");
+        m_falseValues.push_back("F");
+        m_falseValues.push_back("False");
+        m_falseValues.push_back("N");
+        m_falseValues.push_back("No");
+    }
+
+};// namespace CppArgParser
@@ -0,0 +1,47 @@
+#pragma once
+// the slim header for the compiled CppArgParser library.  it only declares
+// ArgParser; the non-template parts and ArgParser::param for the built-in 
+// types below are compiled once into the library.  to add parameters of 
+// other types, also include ArgParser.h (after this header).
+#ifndef CPPARGPARSER_LIBRARY
+#define CPPARGPARSER_LIBRARY
+#endif
+#ifndef CPPARGPARSER_INLINE
+#define CPPARGPARSER_INLINE
+#endif
+#include "ArgParserCore.h"
+#include <string>
+#include <vector>
+
+// the types ArgParser::param is compiled for, each alone and in a std::vector.
+// size_t is left out as it is the same type as one of the others.
+#define CPPARGPARSER_TYPES(X) \
+    X(bool) \
+    X(CppArgParser::Bool) \
+    X(char) \
+    X(unsigned char) \
+    X(short) \
+    X(unsigned short) \
+    X(int) \
+    X(unsigned int) \
+    X(long) \
+    X(unsigned long) \
+    X(long long) \
+    X(unsigned long long) \
+    X(std::string)
+
+#define CPPARGPARSER_PARAM_TEMPLATES(prefix, T) \
+    prefix template void CppArgParser::ArgParser::param<T>(T&, CppArgParser::Name, CppArgParser::Name, bool); \
+    prefix template void CppArgParser::ArgParser::param<T>(T&, std::vector<CppArgParser::Name>, CppArgParser::Name, bool); \
+    prefix template T CppArgParser::ArgParser::param<T>(CppArgParser::Name, CppArgParser::Name, bool); \
+    prefix template T CppArgParser::ArgParser::param<T>(std::vector<CppArgParser::Name>, CppArgParser::Name, bool);
+
+#define CPPARGPARSER_EXTERN_TEMPLATES(T) \
+    CPPARGPARSER_PARAM_TEMPLATES(extern, T) \
+    CPPARGPARSER_PARAM_TEMPLATES(extern, std::vector<T>)
+
+#define CPPARGPARSER_INSTANTIATE_TEMPLATES(T) \
+    CPPARGPARSER_PARAM_TEMPLATES(, T) \
+    CPPARGPARSER_PARAM_TEMPLATES(, std::vector<T>)
+
+CPPARGPARSER_TYPES(CPPARGPARSER_EXTERN_TEMPLATES)
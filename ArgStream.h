@@ -0,0 +1,315 @@
+#pragma once
+#include "ArgParser.h"
+#include <string>
+#include <vector>
+#include <array>
+#include <functional>
+#include <unordered_map>
+#include <stdexcept>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+
+namespace CppArgParser
+{
+
+    // how ArgStream converts the value of an option for its callback.  flags
+    // take no separate value: bool is always true, and Bool also takes
+    // "--flag=value" like it does in ArgParser.
+    template<typename T>
+    struct StreamTraits
+    {
+        enum { flag = 0 };
+
+        T convert(const std::string& value, bool given)
+        {
+            return lexical_cast<T>(value);
+        }
+    };
+
+    template<>
+    struct StreamTraits<bool>
+    {
+        enum { flag = 1 };
+
+        bool convert(const std::string& value, bool given)
+        {
+            if (given)
+                throw syntax_error();
+            return true;
+        }
+    };
+
+    template<>
+    struct StreamTraits<Bool>
+    {
+        enum { flag = 1 };
+
+        Bool convert(const std::string& value, bool given)
+        {
+            if (given)
+                return m_traits.convert(value);
+            return true;
+        }
+
+        ParamTraits<Bool> m_traits;
+    };
+
+    // parses NUL-delimited arguments (as written by find -print0 and read by
+    // xargs -0) as they arrive, and calls back once per value instead of
+    // collecting them.  only the token being read is kept, so memory use does
+    // not depend on how many values there are.
+    //
+    //     ArgStream stream;
+    //     stream.on<int>("--id", [&](const int& id) { ... });
+    //     stream.on<std::string>("file", [&](const std::string& file) { ... });
+    //     stream.parse(0);
+    //     stream.valid();
+    class ArgStream
+    {
+    public:
+        ArgStream()
+        :   m_handlers(),
+            m_positional(),
+            m_pending(0),
+            m_token(),
+            m_name(),
+            m_value(),
+            m_errors(),
+            m_valid(true)
+        {
+        }
+
+        // an option ("--id") is called back with each of its values.  a name
+        // without a leading '-' is called back with every other token.
+        template<typename T>
+        void on(Name name, std::function<void(const T&)> fn);
+
+        // read until the end of fd, in chunks
+        void parse(int fd);
+
+        // read the characters in [first, last)
+        template<typename InputIt>
+        void parse(InputIt first, InputIt last);
+
+        // throws like ArgParser::valid() if parsing stopped at an error
+        bool valid();
+
+    private:
+        struct Handler
+        {
+            Name m_name;
+            bool m_flag;
+            std::function<void(const std::string& value, bool given)> m_call;
+        };
+
+        template<typename InputIt>
+        void feed(InputIt first, InputIt last);
+
+        void feed(const char* first, const char* last);
+
+        void token(const std::string& token);
+
+        void call(Handler& handler, const std::string& value, bool given);
+
+        void finish();
+
+        void error(Name message);
+
+        std::unordered_map<Name, Handler> m_handlers;
+        std::vector<Handler> m_positional;
+        Handler* m_pending;
+        std::string m_token;
+        std::string m_name;
+        std::string m_value;
+        std::string m_errors;
+        bool m_valid;
+    };
+
+    template<typename T>
+    void ArgStream::on(Name name, std::function<void(const T&)> fn)
+    {
+        StreamTraits<T> traits;
+        Handler handler = { name, bool(StreamTraits<T>::flag),
+            [traits, fn](const std::string& value, bool given) mutable
+            {
+                fn(traits.convert(value, given));
+            } };
+
+        if (name.size() && name[0] != '-')
+        {
+            // every token that is not an option goes to the same place
+            if (m_positional.size())
+                error(name + ": ambiguous, " + m_positional[0].m_name + " takes all remaining values");
+            else
+                m_positional.push_back(handler);
+            return;
+        }
+
+        if (!m_handlers.insert(std::make_pair(name, handler)).second)
+            error("every parameter must have a unique name");
+    }
+
+    template<typename InputIt>
+    void ArgStream::parse(InputIt first, InputIt last)
+    {
+        feed(first, last);
+        finish();
+    }
+
+    template<typename InputIt>
+    void ArgStream::feed(InputIt first, InputIt last)
+    {
+        for (; first != last && m_valid; ++first)
+        {
+            char c = *first;
+            if (c)
+            {
+                m_token += c;
+                continue;
+            }
+            token(m_token);
+            m_token.clear();
+        }
+    }
+
+    inline
+    void ArgStream::feed(const char* first, const char* last)
+    {
+        while (first != last && m_valid)
+        {
+            const char* end = static_cast<const char*>(std::memchr(first, '\0', last - first));
+            if (!end)
+            {
+                m_token.append(first, last);
+                return;
+            }
+            m_token.append(first, end);
+            token(m_token);
+            m_token.clear();
+            first = end + 1;
+        }
+    }
+
+    inline
+    void ArgStream::parse(int fd)
+    {
+        std::array<char, 65536> buffer;
+        while (m_valid)
+        {
+            ssize_t size = ::read(fd, buffer.data(), buffer.size());
+            if (size < 0 && errno == EINTR)
+                continue;
+            if (size < 0)
+            {
+                error(Name("ArgStream read failed: ") + std::strerror(errno));
+                return;
+            }
+            if (size == 0)
+                break;
+            feed(static_cast<const char*>(buffer.data()), buffer.data() + size);
+        }
+        finish();
+    }
+
+    inline
+    void ArgStream::token(const std::string& token)
+    {
+        if (m_pending)
+        {
+            // "--opt value"
+            Handler& handler = *m_pending;
+            m_pending = 0;
+            call(handler, token, true);
+            return;
+        }
+
+        if (!token.size() || token[0] != '-')
+        {
+            // "value"
+            if (m_positional.size())
+                call(m_positional[0], token, true);
+            else
+                error("ArgParser unknown name \"" + token + "\"");
+            return;
+        }
+
+        size_t equals = token.find('=');
+        m_name.assign(token, 0, equals);
+        auto found = m_handlers.find(m_name);
+        if (found == m_handlers.end())
+        {
+            error("ArgParser unknown name \"" + token + "\"");
+            return;
+        }
+
+        Handler& handler = found->second;
+        if (equals != std::string::npos)
+        {
+            // "--opt=value"
+            m_value.assign(token, equals + 1, std::string::npos);
+            call(handler, m_value, true);
+        }
+        else if (handler.m_flag)
+        {
+            // "--flag"
+            m_value.clear();
+            call(handler, m_value, false);
+        }
+        else
+        {
+            m_pending = &handler;
+        }
+    }
+
+    inline
+    void ArgStream::call(Handler& handler, const std::string& value, bool given)
+    {
+        try
+        {
+            handler.m_call(value, given);
+        }
+        catch (bad_lexical_cast&)
+        {
+            error(handler.m_name + " failed conversion");
+        }
+        catch (syntax_error&)
+        {
+            error(handler.m_name + ": syntax error");
+        }
+    }
+
+    inline
+    void ArgStream::finish()
+    {
+        // the last token does not need a terminating NUL
+        if (m_valid && m_token.size())
+        {
+            token(m_token);
+            m_token.clear();
+        }
+        if (m_valid && m_pending)
+        {
+            error(m_pending->m_name + " is required");
+        }
+        m_pending = 0;
+    }
+
+    inline
+    void ArgStream::error(Name message)
+    {
+        // parsing stops at the first error, so there is only ever one
+        if (m_valid)
+            m_errors = message + "\n";
+        m_valid = false;
+    }
+
+    inline
+    bool ArgStream::valid()
+    {
+        if (!m_valid)
+            throw std::runtime_error(m_errors);
+        return m_valid;
+    }
+
+};// namespace CppArgParser
@@ -0,0 +1,97 @@
+#include "ArgParser.h"
+#include "ParserSchema.h"
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <chrono>
+#include <cmath>
+
+// parse the command line made by make_args(size) with the ParserTest 
+// parameters and return the best time of a few runs in seconds
+template<typename MakeArgs>
+double measure(MakeArgs make_args, size_t size)
+{
+    std::vector<std::string> tokens = make_args(size);
+    tokens.insert(tokens.begin(), "ComplexityTest");
+    std::vector<char*> argv;
+    for (auto& token : tokens)
+        argv.push_back(&token[0]);
+    argv.push_back(0);
+
+    double best = 0;
+    for (int run = 0; run < 3; ++run)
+    {
+        auto start = std::chrono::steady_clock::now();
+        ParserSchema values;
+        CppArgParser::ArgParser args(argv.size() - 1, &argv[0], "Test the CppArgParser");
+        values.configure(args);
+        args.valid();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        if (!run || elapsed.count() < best)
+            best = elapsed.count();
+    }
+    return best;
+}
+
+// fail if the parse time grows faster than linearly with size.  the
+// allowed slope of log(time) over log(size) leaves room for timing noise.
+template<typename MakeArgs>
+bool linear(std::string name, MakeArgs make_args, size_t first, size_t last)
+{
+    double small = measure(make_args, first);
+    double large = measure(make_args, last);
+    double slope = std::log(large / small) / std::log(double(last) / first);
+    std::cout << name << (slope < 1.4 ? "linear" : "NOT linear") << std::endl;
+    if (slope >= 1.4)
+        std::cout << "  slope " << slope << " from " << first << " to " << last << std::endl;
+    return slope < 1.4;
+}
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        // many instances of one option, in all the spellings
+        auto tokens = [](size_t size)
+        {
+            std::vector<std::string> tokens;
+            while (tokens.size() < size)
+            {
+                tokens.push_back("--n_m");
+                tokens.push_back("1");
+                tokens.push_back("--n_m=2");
+            }
+            return tokens;
+        };
+
+        // one very long value
+        auto value = [](size_t size)
+        {
+            std::vector<std::string> tokens;
+            tokens.push_back("--str=" + std::string(size, 'x'));
+            return tokens;
+        };
+
+        bool ok = true;
+        ok &= linear("tokens:       ", tokens, 1 << 12, 1 << 16);
+        ok &= linear("value length: ", value, 1 << 12, 1 << 18);
+        return ok ? 0 : 1;
+    }
+    catch (std::runtime_error& e)
+    {
+        if (e.what())
+            std::cerr << "ERROR: " << e.what();
+        return 1;
+    }
+    catch (std::exception& e)
+    {
+        if (e.what())
+            std::cerr << "exception: " << e.what();
+        std::cerr << "Unhandled exception!" << std::endl;
+        return 1;
+    }
+    
+    return 0;
+}
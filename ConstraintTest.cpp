@@ -0,0 +1,68 @@
+#include "ArgParser.h"
+#include "Test.h"
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        ArgParserType::Str tls_cert;
+        ArgParserType::Str tls_key;
+        bool sync = false;
+        bool async = false;
+        ArgParserType::Str input;
+        bool stdin_ = false;
+        bool bogus = false;
+
+        CppArgParser::ArgParser args(argc, argv, "Test the CppArgParser constraints");
+        args.env("CONSTRAINT_");
+        // before the parameters they name
+        args.require("--tls-cert", { "--tls-key" });
+        args.conflict({ "--sync", "--async" });
+        args.param(tls_cert, "--tls-cert", "std::string");
+        args.param(tls_key,  "--tls-key",  "std::string");
+        args.param(sync,     "--sync",     "bool");
+        args.param(async,    "--async",    "bool");
+        std::vector<std::string> input_names = { "--input", "-i" };
+        args.param(input,    input_names, "std::string");
+        args.param(stdin_,   "--stdin",    "bool");
+        args.param(bogus,    "--bogus",    "bool (names a constraint on an unknown name)");
+        // and after, by an alias
+        args.one_of({ "-i", "--stdin" });
+        args.require("--async", { "--input", "--tls-key" });
+        if (bogus)
+            args.require("--bogus", { "--stdin", "--nope" });
+
+        // parse
+        if (!args.valid())
+        {
+            return 1;
+        };
+
+        dump("tls-cert: ", tls_cert);
+        dump("tls-key:  ", tls_key);
+        dump("sync:     ", sync);
+        dump("async:    ", async);
+        dump("input:    ", input);
+        dump("stdin:    ", stdin_);
+    }
+    catch (std::runtime_error& e)
+    {
+        if (e.what())
+            std::cerr << "ERROR: " << e.what();
+        return 1;
+    }
+    catch (std::exception& e)
+    {
+        if (e.what())
+            std::cerr << "exception: " << e.what();
+        std::cerr << "Unhandled exception!" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
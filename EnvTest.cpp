@@ -0,0 +1,58 @@
+#include "ArgParser.h"
+#include "Test.h"
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        ArgParserType::N n = 0;
+        ArgParserType::N max_conn = 10;
+        ArgParserType::B b = 0;
+        bool flag = false;
+        ArgParserType::Str str = "default";
+        std::vector<ArgParserType::N> n_m;
+
+        CppArgParser::ArgParser args(argc, argv, "Test the CppArgParser");
+        args.env("MYAPP_");
+
+        args.param(n,        "--n",        "int");
+        args.param(max_conn, "--max-conn", "int (mangled name)");
+        args.param(b,        "--b",        "bool");
+        args.param(flag,     "--flag",     "bool (plain)");
+        args.param(str,      "--str",      "std::string");
+        args.param(n_m,      "--n_m",      "int (multiple instances)");
+
+        // parse
+        if (!args.valid())
+        {
+            return 1;
+        };
+
+        dump("n:        ", n);
+        dump("max_conn: ", max_conn);
+        dump("b:        ", b);
+        dump("flag:     ", flag);
+        dump("str:      ", str);
+        dump("n_m:      ", n_m);
+    }
+    catch (std::runtime_error& e)
+    {
+        if (e.what())
+            std::cerr << "ERROR: " << e.what();
+        return 1;
+    }
+    catch (std::exception& e)
+    {
+        if (e.what())
+            std::cerr << "exception: " << e.what();
+        std::cerr << "Unhandled exception!" << std::endl;
+        return 1;
+    }
+    
+    return 0;
+}
@@ -0,0 +1,123 @@
+#include "ArgParser.h"
+#include "Test.h"
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+struct Values
+{
+    Values() : n(0), verbose(false) {}
+    ArgParserType::N n;
+    std::vector<ArgParserType::Str> files;
+    ArgParserType::Str str;
+    std::vector<ArgParserType::N> n_m;
+    ArgParserType::B b;
+    bool verbose;
+    ArgParserType::Str log_dir;
+};
+
+void configure(CppArgParser::ArgParser& args, Values& values)
+{
+    // how the output looks does not change what it is
+    args.fingerprint_exclude("--verbose");
+    args.fingerprint_exclude("--log-dir");
+
+    args.param(values.n,       "--n",       "int");
+    // positional values are bound last but hashed in their place
+    args.param(values.files,   "files",     "std::string (positional)");
+    args.param(values.str,     "--str",     "std::string");
+    args.param(values.n_m,     "--n_m",     "int (multiple instances)");
+    args.param(values.b,       "--b",       "bool");
+    args.param(values.verbose, "--verbose", "bool (not in the fingerprint)");
+    args.param(values.log_dir, "--log-dir", "std::string (not in the fingerprint)");
+}
+
+CppArgParser::Fingerprint parse(int argc, char* argv[], const std::string* snapshot = 0, bool extra = false)
+{
+    Values values;
+    CppArgParser::ArgParser args(argc, argv, "Test the CppArgParser fingerprint");
+    if (snapshot)
+        args.snapshot_from(snapshot->data(), snapshot->size());
+    configure(args, values);
+    if (extra)
+    {
+        ArgParserType::L l = 0;
+        args.param(l, "--l", "long");
+    }
+    args.valid();
+    return args.fingerprint();
+}
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        std::string blob;
+        Values values;
+        CppArgParser::ArgParser args(argc, argv, "Test the CppArgParser fingerprint");
+        args.snapshot_to(blob);
+        configure(args, values);
+
+        // parse
+        if (!args.valid())
+        {
+            return 1;
+        };
+
+        CppArgParser::Fingerprint fingerprint = args.fingerprint();
+        dump("fingerprint: ", fingerprint.hex());
+
+        // values bound from a snapshot have the same fingerprint
+        char* worker_argv[] = { argv[0], (char*)"--n", (char*)"99", 0 };
+        bool same = parse(3, worker_argv, &blob) == fingerprint;
+        dump("snapshot:    ", same ? "same" : "different");
+
+        // a snapshot with more parameters falls back to the worker's own
+        // command line, and the fingerprint follows it
+        std::string longer;
+        {
+            Values more;
+            ArgParserType::L l = 0;
+            CppArgParser::ArgParser args(argc, argv, "Test the CppArgParser fingerprint");
+            args.snapshot_to(longer);
+            configure(args, more);
+            args.param(l, "--l", "long");
+            args.valid();
+        }
+        same = parse(3, worker_argv, &longer) == parse(3, worker_argv);
+        dump("fallback:    ", same ? "same" : "different");
+
+        // excluding a parameter that was already added is an error
+        {
+            Values late;
+            CppArgParser::ArgParser args(1, argv, "Test the CppArgParser fingerprint");
+            args.param(late.n, "--n", "int");
+            args.fingerprint_exclude("--n");
+            try
+            {
+                args.valid();
+            }
+            catch (std::runtime_error& e)
+            {
+                std::cout << "late:        " << e.what();
+            }
+        }
+    }
+    catch (std::runtime_error& e)
+    {
+        if (e.what())
+            std::cerr << "ERROR: " << e.what();
+        return 1;
+    }
+    catch (std::exception& e)
+    {
+        if (e.what())
+            std::cerr << "exception: " << e.what();
+        std::cerr << "Unhandled exception!" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
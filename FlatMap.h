@@ -0,0 +1,192 @@
+#pragma once
+#include <vector>
+#include <utility>
+#include <functional>
+#include <iterator>
+#include <cstddef>
+
+namespace CppArgParser
+{
+
+    // an open addressing hash map (linear probing, power of two capacity)
+    // with its entries in one array.  it covers what map parameters need:
+    // insert, find, operator[] and iteration, but not erase.  keys and 
+    // values need default constructors.
+    template<typename K, typename V, typename Hash = std::hash<K>>
+    class FlatMap
+    {
+    public:
+        typedef K key_type;
+        typedef V mapped_type;
+        typedef std::pair<K, V> value_type;
+
+        template<typename Map, typename Value>
+        class basic_iterator
+        {
+        public:
+            typedef std::forward_iterator_tag iterator_category;
+            typedef typename FlatMap::value_type value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef Value* pointer;
+            typedef Value& reference;
+
+            basic_iterator() : m_map(0), m_slot(0) {}
+            basic_iterator(Map* map, size_t slot) : m_map(map), m_slot(slot) { skip(); }
+
+            // iterator to const_iterator
+            template<typename OtherMap, typename OtherValue>
+            basic_iterator(const basic_iterator<OtherMap, OtherValue>& other)
+                : m_map(other.m_map), m_slot(other.m_slot) {}
+
+            reference operator*() const { return m_map->m_slots[m_slot]; }
+            pointer operator->() const { return &m_map->m_slots[m_slot]; }
+
+            basic_iterator& operator++()
+            {
+                ++m_slot;
+                skip();
+                return *this;
+            }
+
+            basic_iterator operator++(int)
+            {
+                basic_iterator old(*this);
+                ++*this;
+                return old;
+            }
+
+            bool operator==(const basic_iterator& other) const { return m_slot == other.m_slot; }
+            bool operator!=(const basic_iterator& other) const { return m_slot != other.m_slot; }
+
+        private:
+            template<typename, typename> friend class basic_iterator;
+            friend class FlatMap;
+
+            void skip()
+            {
+                while (m_map && m_slot < m_map->m_used.size() && !m_map->m_used[m_slot])
+                    ++m_slot;
+            }
+
+            Map* m_map;
+            size_t m_slot;
+        };
+
+        typedef basic_iterator<FlatMap, value_type> iterator;
+        typedef basic_iterator<const FlatMap, const value_type> const_iterator;
+
+        FlatMap() : m_slots(), m_used(), m_size(0), m_hash() {}
+
+        size_t size() const { return m_size; }
+        bool empty() const { return !m_size; }
+
+        iterator begin() { return iterator(this, 0); }
+        iterator end() { return iterator(this, m_used.size()); }
+        const_iterator begin() const { return const_iterator(this, 0); }
+        const_iterator end() const { return const_iterator(this, m_used.size()); }
+
+        void swap(FlatMap& other)
+        {
+            m_slots.swap(other.m_slots);
+            m_used.swap(other.m_used);
+            std::swap(m_size, other.m_size);
+            std::swap(m_hash, other.m_hash);
+        }
+
+        void clear()
+        {
+            m_slots.clear();
+            m_used.clear();
+            m_size = 0;
+        }
+
+        // make room for count entries in all without growing again
+        void reserve(size_t count)
+        {
+            size_t capacity = 8;
+            // keep the table at most 3/4 full
+            while (capacity - capacity / 4 < count)
+                capacity *= 2;
+            if (capacity > m_used.size())
+                rehash(capacity);
+        }
+
+        iterator find(const K& key)
+        {
+            return iterator(this, lookup(key));
+        }
+
+        const_iterator find(const K& key) const
+        {
+            return const_iterator(this, lookup(key));
+        }
+
+        size_t count(const K& key) const
+        {
+            return lookup(key) != m_used.size();
+        }
+
+        std::pair<iterator, bool> insert(const value_type& value)
+        {
+            size_t slot = lookup(value.first);
+            if (slot != m_used.size())
+                return std::make_pair(iterator(this, slot), false);
+            if ((m_size + 1) * 4 > m_used.size() * 3)
+            {
+                rehash(m_used.size() ? m_used.size() * 2 : 8);
+            }
+            slot = probe(value.first);
+            m_slots[slot] = value;
+            m_used[slot] = true;
+            m_size++;
+            return std::make_pair(iterator(this, slot), true);
+        }
+
+        V& operator[](const K& key)
+        {
+            return insert(value_type(key, V())).first->second;
+        }
+
+    private:
+        // the slot holding key, or the end
+        size_t lookup(const K& key) const
+        {
+            if (!m_size)
+                return m_used.size();
+            size_t slot = probe(key);
+            return m_used[slot] ? slot : m_used.size();
+        }
+
+        // the slot holding key, or the free slot where it would go
+        size_t probe(const K& key) const
+        {
+            size_t mask = m_used.size() - 1;
+            size_t slot = m_hash(key) & mask;
+            while (m_used[slot] && !(m_slots[slot].first == key))
+                slot = (slot + 1) & mask;
+            return slot;
+        }
+
+        void rehash(size_t capacity)
+        {
+            std::vector<value_type> slots(capacity);
+            std::vector<bool> used(capacity);
+            slots.swap(m_slots);
+            used.swap(m_used);
+            for (size_t slot = 0; slot < used.size(); ++slot)
+            {
+                if (!used[slot])
+                    continue;
+                size_t free = probe(slots[slot].first);
+                m_slots[free] = std::move(slots[slot]);
+                m_used[free] = true;
+            }
+        }
+
+        std::vector<value_type> m_slots;
+        std::vector<bool> m_used;
+        size_t m_size;
+        Hash m_hash;
+    };
+
+};// namespace CppArgParser
@@ -0,0 +1,66 @@
+#include "ArgParser.h"
+#include "ParserSchema.h"
+#include <iostream>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <cstdint>
+
+// libFuzzer entry point: the input is split on NUL into argv[1..] and parsed
+// with the ParserTest parameters.  every outcome other than a crash, a hang 
+// or a sanitizer report is acceptable.
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+    std::vector<std::string> tokens(1, "FuzzTest");
+    std::string input(reinterpret_cast<const char*>(data), size);
+    size_t start = 0;
+    while (start < input.size())
+    {
+        size_t end = input.find('\0', start);
+        if (end == std::string::npos)
+            end = input.size();
+        tokens.push_back(input.substr(start, end - start));
+        start = end + 1;
+    }
+
+    std::vector<char*> argv;
+    for (auto& token : tokens)
+        argv.push_back(&token[0]);
+    argv.push_back(0);
+
+    try
+    {
+        // discard the help text
+        std::ostream null(0);
+        ParserSchema values;
+        CppArgParser::ArgParser args(argv.size() - 1, &argv[0], "Test the CppArgParser", "", null);
+        values.configure(args);
+        args.valid();
+    }
+    catch (std::runtime_error&)
+    {
+    }
+    return 0;
+}
+
+#ifndef CPPARGPARSER_LIBFUZZER
+// without libFuzzer, replay the inputs named on the command line
+int main(int argc, char* argv[])
+{
+    for (int argn = 1; argn < argc; argn++)
+    {
+        std::ifstream file(argv[argn], std::ios::binary);
+        if (!file)
+        {
+            std::cerr << "ERROR: cannot read " << argv[argn] << std::endl;
+            return 1;
+        }
+        std::string input((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        LLVMFuzzerTestOneInput(reinterpret_cast<const uint8_t*>(input.data()), input.size());
+    }
+    std::cout << argc - 1 << " inputs" << std::endl;
+    return 0;
+}
+#endif
@@ -0,0 +1,73 @@
+#include "ArgParserLib.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+// only the slim header: everything below comes from the CppArgParser library
+
+template<typename T>
+void dump(std::string name, T t)
+{
+    std::cout << name << t << std::endl;
+}
+
+template<typename T>
+void dump(std::string name, std::vector<T> t_m)
+{
+    std::cout << name;
+    for (auto t: t_m)
+        std::cout << t << ", ";
+    std::cout << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        CppArgParser::Bool b;
+        int n = 0;
+        unsigned long long ull = 0;
+        std::string str;
+        std::vector<int> n_m;
+        std::vector<std::string> str_m;
+
+        CppArgParser::ArgParser args(argc, argv, "Test the CppArgParser library");
+        args.param(b,     "--b",     "bool");
+        args.param(n,     "--n",     "int");
+        args.param(ull,   "--ull",   "unsigned long long");
+        args.param(str,   "--str",   "std::string");
+        args.param(n_m,   "--n_m",   "int (multiple instances)");
+        args.param(str_m, "--str_m", "std::string (multiple instances)");
+        long l = args.param<long>("--l", "long (returned)");
+
+        // parse
+        if (!args.valid())
+        {
+            return 1;
+        };
+
+        dump("b:      ", b.m_b);
+        dump("n:      ", n);
+        dump("ull:    ", ull);
+        dump("str:    ", str);
+        dump("n_m:    ", n_m);
+        dump("str_m:  ", str_m);
+        dump("l:      ", l);
+    }
+    catch (std::runtime_error& e)
+    {
+        if (e.what())
+            std::cerr << "ERROR: " << e.what();
+        return 1;
+    }
+    catch (std::exception& e)
+    {
+        if (e.what())
+            std::cerr << "exception: " << e.what();
+        std::cerr << "Unhandled exception!" << std::endl;
+        return 1;
+    }
+    
+    return 0;
+}
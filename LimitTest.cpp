@@ -0,0 +1,65 @@
+#include "ArgParser.h"
+#include "Test.h"
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <map>
+#include <stdexcept>
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        ArgParserType::N n = 0;
+        std::vector<ArgParserType::N> n_m;
+        std::map<ArgParserType::Str, ArgParserType::N> define;
+        define["ttl"] = 10;
+        ArgParserType::Str str;
+
+        // what a service taking command lines from its clients might allow
+        CppArgParser::Limits limits;
+        limits.m_max_tokens = 8;
+        limits.m_max_value_bytes = 16;
+        limits.m_max_elements = 3;
+        limits.m_max_errors = 2;
+
+        CppArgParser::ArgParser args(argc, argv, "Test the CppArgParser limits", "", std::cout, limits);
+        args.param(n,      "--n",      "int");
+        args.param(n_m,    "--n_m",    "int (multiple instances)");
+        args.param(define, "--define", "std::map<std::string, int>");
+        args.param(str,    "--str",    "std::string");
+
+        // parse
+        if (!args.valid())
+        {
+            return 1;
+        };
+
+        dump("n:      ", n);
+        std::cout << "n_m:    ";
+        for (auto& value : n_m)
+            std::cout << value << " ";
+        std::cout << std::endl;
+        std::cout << "define: ";
+        for (auto& entry : define)
+            std::cout << entry.first << "=" << entry.second << ", ";
+        std::cout << std::endl;
+        dump("str:    ", str);
+    }
+    catch (std::runtime_error& e)
+    {
+        if (e.what())
+            std::cerr << "ERROR: " << e.what();
+        return 1;
+    }
+    catch (std::exception& e)
+    {
+        if (e.what())
+            std::cerr << "exception: " << e.what();
+        std::cerr << "Unhandled exception!" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
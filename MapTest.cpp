@@ -0,0 +1,83 @@
+#include "ArgParser.h"
+#include "Test.h"
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <stdexcept>
+
+// print any map in key order
+template<typename Map>
+void dump_map(std::string name, const Map& map)
+{
+    std::map<typename Map::key_type, typename Map::mapped_type> sorted(map.begin(), map.end());
+    std::cout << name;
+    for (auto& entry : sorted)
+        std::cout << entry.first << "=" << entry.second << ", ";
+    std::cout << std::endl;
+}
+
+template<typename Map>
+void dump_multi(std::string name, const Map& map)
+{
+    std::map<typename Map::key_type, typename Map::mapped_type> sorted(map.begin(), map.end());
+    std::cout << name;
+    for (auto& entry : sorted)
+    {
+        std::cout << entry.first << "=";
+        for (auto& value : entry.second)
+            std::cout << value << " ";
+        std::cout << ", ";
+    }
+    std::cout << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        std::map<ArgParserType::Str, ArgParserType::N> define;
+        define["ttl"] = 10;
+        define["keep"] = 1;
+        std::unordered_map<ArgParserType::N, ArgParserType::Str> id;
+        CppArgParser::FlatMap<ArgParserType::Str, std::vector<ArgParserType::N>> tag;
+        CppArgParser::FlatMap<ArgParserType::Str, ArgParserType::N> limit;
+
+        CppArgParser::ArgParser args(argc, argv, "Test the CppArgParser maps");
+        args.param(define, "--define", "std::map<std::string, int> (duplicate keys are errors)");
+        args.duplicate_keys(CppArgParser::keys_last_wins);
+        args.param(id,     "--id",     "std::unordered_map<int, std::string> (the last value wins)");
+        args.duplicate_keys(CppArgParser::keys_collect);
+        args.param(tag,    "--tag",    "FlatMap<std::string, std::vector<int>> (values are collected)");
+        args.param(limit,  "--limit",  "FlatMap<std::string, int> (cannot collect)");
+
+        // parse
+        if (!args.valid())
+        {
+            return 1;
+        };
+
+        dump_map("define: ", define);
+        dump_map("id:     ", id);
+        dump_multi("tag:    ", tag);
+        dump_map("limit:  ", limit);
+        dump("fingerprint: ", args.fingerprint().hex());
+    }
+    catch (std::runtime_error& e)
+    {
+        if (e.what())
+            std::cerr << "ERROR: " << e.what();
+        return 1;
+    }
+    catch (std::exception& e)
+    {
+        if (e.what())
+            std::cerr << "exception: " << e.what();
+        std::cerr << "Unhandled exception!" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -1,5 +1,5 @@
 #include "ArgParser.h"
-#include "Test.h"
+#include "ParserSchema.h"
 #include <iostream>
 #include <iomanip>
 #include <string>
@@ -10,67 +10,10 @@ int main(int argc, char* argv[])
 {
     try
     {
-        // declare single instance args
-        ArgParserType::B    b    = 0;
-        ArgParserType::C    c    = 0;
-        ArgParserType::UC   uc   = 0;
-        ArgParserType::S    s    = 0;
-        ArgParserType::US   us   = 0;
-        ArgParserType::N    n    = 0;
-        ArgParserType::UN   un   = 0;
-        ArgParserType::L    l    = 0;
-        ArgParserType::UL   ul   = 0;
-        ArgParserType::LL   ll   = 0;
-        ArgParserType::ULL  ull  = 0;
-        ArgParserType::Size size = 0;
-        ArgParserType::Str  str  = "";
-      
-        // declare multiple instance args
-        std::vector<ArgParserType::B>    b_m;
-        std::vector<ArgParserType::C>    c_m;
-        std::vector<ArgParserType::UC>   uc_m;
-        std::vector<ArgParserType::S>    s_m;
-        std::vector<ArgParserType::US>   us_m;
-        std::vector<ArgParserType::N>    n_m;
-        std::vector<ArgParserType::UN>   un_m;
-        std::vector<ArgParserType::L>    l_m;
-        std::vector<ArgParserType::UL>   ul_m;
-        std::vector<ArgParserType::LL>   ll_m;
-        std::vector<ArgParserType::ULL>  ull_m;
-        std::vector<ArgParserType::Size> size_m;
-        std::vector<ArgParserType::Str>  str_m;
+        ParserSchema values;
 
         CppArgParser::ArgParser args(argc, argv, "Test the CppArgParser");
-
-        // configure single instance arguments
-        args.param(b,    "--b",      "bool");
-        args.param(c,    "--c",      "char");
-        args.param(uc,   "--uc",     "unsigned char");
-        args.param(s,    "--s",      "short");
-        args.param(us,   "--us",     "unsigned short");
-        args.param(n,    "--n",      "int");
-        args.param(un,   "--un",     "unsigned int");
-        args.param(l,    "--l",      "long");
-        args.param(ul,   "--ul",     "unsigned long");
-        args.param(ll,   "--ll",     "long long");
-        args.param(ull,  "--ull",    "unsigned long long");
-        args.param(size, "--size",   "size_t");
-        args.param(str,  "--str",    "std::string");
-
-        // configure multiple instance arguments
-        args.param(b_m,    "--b_m",      "bool (multiple instances)");
-        args.param(c_m,    "--c_m",      "char (multiple instances)");
-        args.param(uc_m,   "--uc_m",     "unsigned char (multiple instances)");
-        args.param(s_m,    "--s_m",      "short (multiple instances)");
-        args.param(us_m,   "--us_m",     "unsigned short (multiple instances)");
-        args.param(n_m,    "--n_m",      "int (multiple instances)");
-        args.param(un_m,   "--un_m",     "unsigned int (multiple instances)");
-        args.param(l_m,    "--l_m",      "long (multiple instances)");
-        args.param(ul_m,   "--ul_m",     "unsigned long (multiple instances)");
-        args.param(ll_m,   "--ll_m",     "long long (multiple instances)");
-        args.param(ull_m,  "--ull_m",    "unsigned long long (multiple instances)");
-        args.param(size_m, "--size_m",   "size_t (multiple instances)");
-        args.param(str_m,  "--str_m",    "std::string (multiple instances)");
+        values.configure(args);
         
         // parse
         if (!args.valid())
@@ -79,33 +22,7 @@ int main(int argc, char* argv[])
         };
 
         // output
-        dump("b:      ", b.m_b);
-        dump("c:      ", (int)c);
-        dump("uc:     ", (int)uc);
-        dump("s:      ", s);
-        dump("us:     ", us);
-        dump("n:      ", n);
-        dump("un:     ", un);
-        dump("l:      ", l);
-        dump("ul:     ", ul);
-        dump("ll:     ", ll);
-        dump("ull:    ", ull);
-        dump("size:   ", size);
-        dump("str:    ", str);
-
-        dump("b_m:    ", b_m);
-        dump("c_m:    ", c_m);
-        dump("uc_m:   ", uc_m);
-        dump("s_m:    ", s_m);
-        dump("us_m:   ", us_m);
-        dump("n_m:    ", n_m);
-        dump("un_m:   ", un_m);
-        dump("l_m:    ", l_m);
-        dump("ul_m:   ", ul_m);
-        dump("ll_m:   ", ll_m);
-        dump("ull_m:  ", ull_m);
-        dump("size_m: ", size_m);
-        dump("str_m:  ", str_m);
+        values.dump();
     }
     catch (std::runtime_error& e)
     {
@@ -123,4 +40,3 @@ int main(int argc, char* argv[])
     
     return 0;
 }
-
@@ -0,0 +1,63 @@
+#include "ArgParser.h"
+#include "Test.h"
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        bool at_positional = false;
+        bool strict = false;
+        ArgParserType::N n = 0;
+        bool v = false;
+        ArgParserType::Str str;
+
+        CppArgParser::ArgParser args(argc, argv, "Test passing arguments through to a child");
+        args.param(at_positional, "--at-positional", "the first positional ends the options");
+        args.param(strict,        "--strict",        "do not allow a passthrough at all");
+        args.param(n,             "--n",             "int");
+        args.param(v,             "--v",             "bool");
+        args.param(str,           "--str",           "std::string");
+        if (!strict)
+            args.allow_passthrough(at_positional);
+
+        // parse
+        if (!args.valid())
+        {
+            return 1;
+        };
+
+        dump("n:           ", n);
+        dump("v:           ", v);
+        dump("str:         ", str);
+
+        CppArgParser::Passthrough child = args.passthrough();
+        std::cout << "passthrough: " << child.m_argc << ":";
+        for (int argn = 0; argn < child.m_argc; ++argn)
+            std::cout << " " << child.m_argv[argn];
+        std::cout << std::endl;
+
+        // ready for execv(child.m_argv[0], child.m_argv)
+        bool in_place = child.m_argv > argv && child.m_argv <= argv + argc && !child.m_argv[child.m_argc];
+        dump("in argv:     ", in_place);
+    }
+    catch (std::runtime_error& e)
+    {
+        if (e.what())
+            std::cerr << "ERROR: " << e.what();
+        return 1;
+    }
+    catch (std::exception& e)
+    {
+        if (e.what())
+            std::cerr << "exception: " << e.what();
+        std::cerr << "Unhandled exception!" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
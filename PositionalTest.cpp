@@ -0,0 +1,55 @@
+#include "ArgParser.h"
+#include "Test.h"
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        CppArgParser::ArgParser args(argc, argv, "Test the CppArgParser");
+
+        ArgParserType::N first = 0;
+        args.param(first, "first", "one int");
+
+        std::array<int, 2> pair;
+        pair.fill(0);
+        args.param(pair, "pair", "two ints");
+
+        std::vector<int> rest;
+        args.param(rest, "rest", "N ints");
+
+        // an option added after the positional ones still takes its own value
+        ArgParserType::N n = 0;
+        args.param(n, "--n", "int");
+
+        // parse
+        if (!args.valid())
+        {
+            return 1;
+        };
+
+        dump("first:  ", first);
+        dump("pair:   ", pair);
+        dump("n:      ", n);
+        dump("rest:   ", rest);
+    }
+    catch (std::runtime_error& e)
+    {
+        if (e.what())
+            std::cerr << "ERROR: " << e.what();
+        return 1;
+    }
+    catch (std::exception& e)
+    {
+        if (e.what())
+            std::cerr << "exception: " << e.what();
+        std::cerr << "Unhandled exception!" << std::endl;
+        return 1;
+    }
+    
+    return 0;
+}
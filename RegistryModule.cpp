@@ -0,0 +1,19 @@
+#include "ArgParser.h"
+#include <iostream>
+#include <string>
+#include <vector>
+
+// a "module" that owns its parameters
+CPPARGPARSER_PARAM(int,                      pool_size, "--pool-size", "int (declared in another file)", 4);
+CPPARGPARSER_PARAM(std::string,              pool_name, "--pool-name", "std::string (declared in another file)", "default");
+CPPARGPARSER_PARAM(std::vector<std::string>, pool_tags, "--pool-tag",  "std::string (declared in another file, multiple instances)", std::vector<std::string>());
+
+void dump_module()
+{
+    std::cout << "pool_size: " << *pool_size << std::endl;
+    std::cout << "pool_name: " << *pool_name << std::endl;
+    std::cout << "pool_tags: ";
+    for (auto tag : *pool_tags)
+        std::cout << tag << ", ";
+    std::cout << std::endl;
+}
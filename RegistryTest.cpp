@@ -0,0 +1,54 @@
+#include "ArgParser.h"
+#include "Test.h"
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+CPPARGPARSER_PARAM(ArgParserType::N,   count,   "--count",   "int", 1);
+CPPARGPARSER_PARAM(ArgParserType::B,   verbose, "--verbose", "bool", false);
+
+// declared in RegistryModule.cpp
+CPPARGPARSER_DECLARE(int, pool_size);
+void dump_module();
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        CppArgParser::ArgParser args(argc, argv, "Test the CppArgParser");
+        args.param_registry();
+
+        // parse
+        if (!args.valid())
+        {
+            return 1;
+        };
+
+        dump("count:     ", *count);
+        dump("verbose:   ", *verbose);
+        dump("pool_size: ", *pool_size);
+        dump_module();
+
+        // the registry can only be parsed once
+        CppArgParser::ArgParser again(argc, argv, "Test the CppArgParser");
+        again.param_registry();
+        again.valid();
+    }
+    catch (std::runtime_error& e)
+    {
+        if (e.what())
+            std::cerr << "ERROR: " << e.what();
+        return 1;
+    }
+    catch (std::exception& e)
+    {
+        if (e.what())
+            std::cerr << "exception: " << e.what();
+        std::cerr << "Unhandled exception!" << std::endl;
+        return 1;
+    }
+    
+    return 0;
+}
@@ -0,0 +1,81 @@
+#include "ArgParser.h"
+#include "Test.h"
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+// each module adds its own subtree and does not know the others
+struct Pool
+{
+    Pool() : size(4), timeout(30) {}
+
+    void configure(CppArgParser::Scope scope)
+    {
+        scope.param(size,    "size",    "connections in the pool");
+        scope.param(timeout, "timeout", "seconds to wait for a connection");
+    }
+
+    ArgParserType::N size;
+    ArgParserType::N timeout;
+};
+
+struct Database
+{
+    void configure(CppArgParser::Scope scope)
+    {
+        scope.param(url, "url", "where the database is");
+        pool.configure(scope.scope("pool"));
+    }
+
+    ArgParserType::Str url;
+    Pool pool;
+};
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        Database db;
+        Pool cache;
+        ArgParserType::Str help_scope;
+
+        CppArgParser::ArgParser args(argc, argv, "Test the CppArgParser scopes");
+        args.param(help_scope, "--help-scope", "print the help for this scope");
+        db.configure(args.scope("db"));
+        cache.configure(args.scope("cache.pool"));
+        bool verbose = args.scope("log").param<bool>("verbose", "bool");
+
+        // parse
+        if (!args.valid())
+        {
+            return 1;
+        };
+
+        dump("db.url:             ", db.url);
+        dump("db.pool.size:       ", db.pool.size);
+        dump("db.pool.timeout:    ", db.pool.timeout);
+        dump("cache.pool.size:    ", cache.size);
+        dump("cache.pool.timeout: ", cache.timeout);
+        dump("log.verbose:        ", verbose);
+
+        if (help_scope.size())
+            args.scope(help_scope).print_help(std::cout);
+    }
+    catch (std::runtime_error& e)
+    {
+        if (e.what())
+            std::cerr << "ERROR: " << e.what();
+        return 1;
+    }
+    catch (std::exception& e)
+    {
+        if (e.what())
+            std::cerr << "exception: " << e.what();
+        std::cerr << "Unhandled exception!" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,60 @@
+#include "ArgParserLib.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+// help and errors without iostreams: help goes to a file descriptor first,
+// then to a callback that keeps it, and values are printed with stdio
+
+void capture(void* context, const char* data, size_t size)
+{
+    static_cast<std::string*>(context)->append(data, size);
+}
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        CppArgParser::ArgParser direct(argc, argv, "Test help output sinks", "SinkTest", 
+                                       CppArgParser::fd_sink(1));
+        direct.param<int>("--n", "int");
+        direct.param<unsigned short>("--us", "unsigned short");
+        if (!direct.valid())
+        {
+            std::printf("-- written to fd 1\n");
+        }
+
+        std::string help;
+        CppArgParser::ArgParser args(argc, argv, "Test help output sinks", "SinkTest", 
+                                     CppArgParser::Sink(capture, &help));
+        int n = args.param<int>("--n", "int");
+        unsigned short us = 0;
+        args.param(us, "--us", "unsigned short");
+
+        // parse
+        if (!args.valid())
+        {
+            std::printf("-- captured %u bytes\n%s", unsigned(help.size()), help.c_str());
+            return 1;
+        };
+
+        std::printf("n:      %d\n", n);
+        std::printf("us:     %u\n", unsigned(us));
+    }
+    catch (std::runtime_error& e)
+    {
+        if (e.what())
+            std::fprintf(stderr, "ERROR: %s", e.what());
+        return 1;
+    }
+    catch (std::exception& e)
+    {
+        if (e.what())
+            std::fprintf(stderr, "exception: %s", e.what());
+        std::fprintf(stderr, "Unhandled exception!\n");
+        return 1;
+    }
+    
+    return 0;
+}
@@ -0,0 +1,129 @@
+#include "ArgParser.h"
+#include "Test.h"
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+struct Values
+{
+    Values() : n(0), b(false) {}
+    ArgParserType::N n;
+    ArgParserType::B b;
+    ArgParserType::Str str;
+    std::vector<ArgParserType::N> n_m;
+    std::vector<ArgParserType::Str> str_m;
+    std::vector<ArgParserType::Str> files;
+};
+
+void configure(CppArgParser::ArgParser& args, Values& values)
+{
+    args.param(values.n,     "--n",     "int");
+    args.param(values.b,     "--b",     "bool");
+    // positional values are bound last, but recorded in their place
+    args.param(values.files, "files",   "std::string (positional)");
+    args.param(values.str,   "--str",   "std::string");
+    args.param(values.n_m,   "--n_m",   "int (multiple instances)");
+    args.param(values.str_m, "--str_m", "std::string (multiple instances)");
+}
+
+void dump(std::string prefix, Values& values)
+{
+    dump(prefix + "n:     ", values.n);
+    dump(prefix + "b:     ", values.b);
+    dump(prefix + "str:   ", values.str);
+    dump(prefix + "n_m:   ", values.n_m);
+    dump(prefix + "str_m: ", values.str_m);
+    dump(prefix + "files: ", values.files);
+}
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        // the "supervisor" parses the real command line and records it
+        std::string blob;
+        {
+            Values values;
+            CppArgParser::ArgParser args(argc, argv, "Test the CppArgParser");
+            args.snapshot_to(blob);
+            configure(args, values);
+            if (!args.valid())
+            {
+                return 1;
+            };
+        }
+
+        // a "worker" with the same parameters binds them from the snapshot
+        // and ignores its own command line
+        char* worker_argv[] = { argv[0], (char*)"--n", (char*)"99", 0 };
+        {
+            Values values;
+            CppArgParser::ArgParser args(3, worker_argv, "Test the CppArgParser");
+            args.snapshot_from(blob.data(), blob.size());
+            configure(args, values);
+            if (!args.valid())
+            {
+                return 1;
+            };
+            dump("same:   ", values);
+        }
+
+        // a worker with one more parameter falls back to parsing its own command line
+        {
+            Values values;
+            ArgParserType::L l = 0;
+            CppArgParser::ArgParser args(3, worker_argv, "Test the CppArgParser");
+            args.snapshot_from(blob.data(), blob.size());
+            configure(args, values);
+            args.param(l, "--l", "long");
+            if (!args.valid())
+            {
+                return 1;
+            };
+            dump("extra:  ", values);
+        }
+
+        // a worker that disagrees on a type falls back as well
+        {
+            ArgParserType::L n = 0;
+            CppArgParser::ArgParser args(3, worker_argv, "Test the CppArgParser");
+            args.snapshot_from(blob.data(), blob.size());
+            args.param(n, "--n", "long");
+            if (!args.valid())
+            {
+                return 1;
+            };
+            dump("type:   n:     ", n);
+        }
+
+        // a damaged snapshot is ignored
+        {
+            Values values;
+            CppArgParser::ArgParser args(3, worker_argv, "Test the CppArgParser");
+            args.snapshot_from(blob.data(), blob.size() - 1);
+            configure(args, values);
+            if (!args.valid())
+            {
+                return 1;
+            };
+            dump("short:  ", values);
+        }
+    }
+    catch (std::runtime_error& e)
+    {
+        if (e.what())
+            std::cerr << "ERROR: " << e.what();
+        return 1;
+    }
+    catch (std::exception& e)
+    {
+        if (e.what())
+            std::cerr << "exception: " << e.what();
+        std::cerr << "Unhandled exception!" << std::endl;
+        return 1;
+    }
+    
+    return 0;
+}
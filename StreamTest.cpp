@@ -0,0 +1,154 @@
+#include "ArgStream.h"
+#include "Test.h"
+#include <iostream>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+// peak resident memory in kB
+long peak()
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+// write count "--id <n>" pairs into a pipe from a child process and stream
+// them back, to check that memory use does not grow with the number of values
+void generate(size_t count)
+{
+    int fds[2];
+    if (pipe(fds))
+        throw std::runtime_error("pipe failed\n");
+    pid_t child = fork();
+    if (child == 0)
+    {
+        close(fds[0]);
+        std::string chunk;
+        for (size_t n = 0; n < count; ++n)
+        {
+            chunk += "--id";
+            chunk += '\0';
+            chunk += std::to_string(n);
+            chunk += '\0';
+            if (chunk.size() > 4096 || n + 1 == count)
+            {
+                if (write(fds[1], chunk.data(), chunk.size()) != ssize_t(chunk.size()))
+                    _exit(1);
+                chunk.clear();
+            }
+        }
+        _exit(0);
+    }
+    close(fds[1]);
+
+    size_t seen = 0;
+    unsigned long long sum = 0;
+    CppArgParser::ArgStream stream;
+    stream.on<unsigned long long>("--id", [&](const unsigned long long& id)
+    {
+        seen++;
+        sum += id;
+    });
+
+    long before = peak();
+    stream.parse(fds[0]);
+    long grown = peak() - before;
+    close(fds[0]);
+    waitpid(child, 0, 0);
+    stream.valid();
+
+    dump("seen:    ", seen);
+    dump("sum:     ", sum);
+    // the values alone are several MB
+    dump("memory:  ", grown < 1024 ? "constant" : "grows");
+}
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        ArgParserType::Str input;
+        ArgParserType::B iterator;
+        ArgParserType::Size count = 0;
+
+        CppArgParser::ArgParser args(argc, argv, "Test the CppArgParser NUL-delimited stream");
+        args.param(input,    "--input",    "file of NUL-delimited arguments");
+        args.param(iterator, "--iterator", "read the file through an iterator instead of a descriptor");
+        args.param(count,    "--generate", "stream this many generated values through a pipe");
+
+        // parse
+        if (!args.valid())
+        {
+            return 1;
+        };
+
+        if (count)
+        {
+            generate(count);
+            return 0;
+        }
+
+        CppArgParser::ArgStream stream;
+        stream.on<int>("--id", [](const int& id)
+        {
+            dump("id:      ", id);
+        });
+        stream.on<std::string>("--name", [](const std::string& name)
+        {
+            dump("name:    ", name);
+        });
+        stream.on<bool>("--verbose", [](const bool& verbose)
+        {
+            dump("verbose: ", verbose);
+        });
+        stream.on<CppArgParser::Bool>("--b", [](const CppArgParser::Bool& b)
+        {
+            dump("b:       ", b);
+        });
+        stream.on<std::string>("file", [](const std::string& file)
+        {
+            dump("file:    ", file);
+        });
+
+        if (iterator.m_b)
+        {
+            std::ifstream in(input, std::ios::binary);
+            stream.parse(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        }
+        else
+        {
+            int fd = open(input.c_str(), O_RDONLY);
+            if (fd < 0)
+                throw std::runtime_error("cannot open " + input + "\n");
+            stream.parse(fd);
+            close(fd);
+        }
+
+        if (!stream.valid())
+        {
+            return 1;
+        }
+    }
+    catch (std::runtime_error& e)
+    {
+        if (e.what())
+            std::cerr << "ERROR: " << e.what();
+        return 1;
+    }
+    catch (std::exception& e)
+    {
+        if (e.what())
+            std::cerr << "exception: " << e.what();
+        std::cerr << "Unhandled exception!" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
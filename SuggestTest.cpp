@@ -0,0 +1,60 @@
+#include "ArgParser.h"
+#include "Test.h"
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        bool verbose = false;
+        bool quiet = false;
+        bool secret = false;
+        ArgParserType::Str output;
+        ArgParserType::Str color;
+        ArgParserType::N threads = 0;
+        std::vector<ArgParserType::N> options(2000);
+
+        CppArgParser::ArgParser args(argc, argv, "Test the CppArgParser suggestions for unknown names");
+        args.param(verbose, "--verbose", "bool");
+        args.param(quiet,   "--quiet",   "bool");
+        args.param(secret,  "--secret",  "bool (hidden)", false);
+        args.param(output,  "--output",  "std::string");
+        args.param(color,   "--color",   "std::string");
+        args.param(threads, "--threads", "int");
+        // a large schema, like a generated one
+        for (size_t i = 0; i < options.size(); ++i)
+        {
+            args.param(options[i], "--option-" + std::to_string(1000 + i), "int");
+        }
+
+        // parse
+        if (!args.valid())
+        {
+            return 1;
+        };
+
+        dump("verbose: ", verbose);
+        dump("output:  ", output);
+        dump("threads: ", threads);
+        dump("option:  ", options[234]);
+    }
+    catch (std::runtime_error& e)
+    {
+        if (e.what())
+            std::cerr << "ERROR: " << e.what();
+        return 1;
+    }
+    catch (std::exception& e)
+    {
+        if (e.what())
+            std::cerr << "exception: " << e.what();
+        std::cerr << "Unhandled exception!" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
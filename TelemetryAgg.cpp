@@ -0,0 +1,190 @@
+#include "ArgParser.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <map>
+#include <stdexcept>
+#include <cstring>
+
+// sums up the records that CppArgParser::telemetry() appended to one or more
+// files: how often each parameter was given and where its value came from,
+// and which parameters were never given at all
+
+struct Usage
+{
+    Usage() : m_parses(0), m_seen(0), m_occurrences(0), m_failures(0), m_sources(), m_hidden(false) {}
+
+    size_t m_parses;            // parses that had this parameter
+    size_t m_seen;              // parses that did not use its default
+    size_t m_occurrences;
+    size_t m_failures;
+    size_t m_sources[4];        // parses per CppArgParser::Source
+    bool m_hidden;              // not shown by --help
+};
+
+struct Totals
+{
+    Totals() : m_parses(), m_dropped(0), m_bad(0) {}
+
+    size_t m_parses[3];         // per telemetry_valid, telemetry_help, telemetry_error
+    size_t m_dropped;           // records the writers had no room for
+    size_t m_bad;               // records that could not be read
+    std::map<std::string, Usage> m_usage;
+};
+
+// add up the records in one file.  a damaged record ends the file.
+void aggregate(const std::string& data, Totals& totals)
+{
+    using namespace CppArgParser;
+    size_t pos = 0;
+    while (pos < data.size())
+    {
+        TelemetryHeader header;
+        if (data.size() - pos < sizeof(header))
+        {
+            totals.m_bad++;
+            return;
+        }
+        std::memcpy(&header, data.data() + pos, sizeof(header));
+        pos += sizeof(header);
+        if (std::memcmp(header.m_magic, "CAPT", sizeof(header.m_magic))
+            || header.m_size > data.size() - pos || header.m_result > telemetry_dropped)
+        {
+            totals.m_bad++;
+            return;
+        }
+        if (header.m_result == telemetry_dropped)
+        {
+            if (header.m_size)
+            {
+                totals.m_bad++;
+                return;
+            }
+            totals.m_dropped += header.m_count;
+            continue;
+        }
+
+        size_t end = pos + header.m_size;
+        std::vector<std::pair<std::string, TelemetryRecord>> records;
+        for (uint32_t i = 0; i < header.m_count; ++i)
+        {
+            TelemetryRecord record;
+            if (end - pos < sizeof(record))
+                break;
+            std::memcpy(&record, data.data() + pos, sizeof(record));
+            pos += sizeof(record);
+            if (end - pos < record.m_name_size || record.m_source > source_snapshot)
+                break;
+            records.push_back(std::make_pair(data.substr(pos, record.m_name_size), record));
+            pos += record.m_name_size;
+        }
+        if (records.size() != header.m_count || pos != end)
+        {
+            totals.m_bad++;
+            return;
+        }
+
+        totals.m_parses[header.m_result]++;
+        for (auto& entry : records)
+        {
+            Usage& usage = totals.m_usage[entry.first];
+            const TelemetryRecord& record = entry.second;
+            usage.m_parses++;
+            usage.m_seen += record.m_source != source_default;
+            usage.m_occurrences += record.m_occurrences;
+            usage.m_failures += record.m_failures;
+            usage.m_sources[record.m_source]++;
+            usage.m_hidden = record.m_flags & telemetry_hidden;
+        }
+    }
+}
+
+void report(const Totals& totals)
+{
+    std::cout << "parses: " << totals.m_parses[CppArgParser::telemetry_valid] << " valid, "
+              << totals.m_parses[CppArgParser::telemetry_help] << " help, "
+              << totals.m_parses[CppArgParser::telemetry_error] << " error" << std::endl;
+    if (totals.m_dropped)
+        std::cout << "dropped: " << totals.m_dropped << std::endl;
+    if (totals.m_bad)
+        std::cout << "damaged: " << totals.m_bad << std::endl;
+    std::cout << std::endl;
+
+    size_t width = 4;
+    for (auto& entry : totals.m_usage)
+    {
+        if (width < entry.first.size())
+            width = entry.first.size();
+    }
+
+    std::cout << std::left << std::setw(width + 2) << "name" << std::right
+              << std::setw(8) << "parses" << std::setw(8) << "seen" << std::setw(8) << "count"
+              << std::setw(8) << "failed" << std::setw(8) << "argv" << std::setw(8) << "env"
+              << std::setw(10) << "snapshot" << std::endl;
+    std::vector<std::string> unused;
+    for (auto& entry : totals.m_usage)
+    {
+        const Usage& usage = entry.second;
+        std::cout << std::left << std::setw(width + 2) << entry.first << std::right
+                  << std::setw(8) << usage.m_parses << std::setw(8) << usage.m_seen
+                  << std::setw(8) << usage.m_occurrences << std::setw(8) << usage.m_failures
+                  << std::setw(8) << usage.m_sources[CppArgParser::source_argv]
+                  << std::setw(8) << usage.m_sources[CppArgParser::source_env]
+                  << std::setw(10) << usage.m_sources[CppArgParser::source_snapshot] << std::endl;
+        if (!usage.m_seen)
+            unused.push_back(entry.first + (usage.m_hidden ? " (hidden)" : ""));
+    }
+
+    std::cout << std::endl << "never given:";
+    for (auto& name : unused)
+    {
+        std::cout << " " << name;
+    }
+    std::cout << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        std::vector<std::string> files;
+
+        CppArgParser::ArgParser args(argc, argv, "Sum up CppArgParser telemetry files");
+        args.param(files, "file", "telemetry file written by CppArgParser::telemetry()");
+
+        // parse
+        if (!args.valid())
+        {
+            return 1;
+        };
+
+        Totals totals;
+        for (auto& file : files)
+        {
+            std::ifstream in(file, std::ios::binary);
+            if (!in)
+                throw std::runtime_error("cannot read " + file + "\n");
+            std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+            aggregate(data, totals);
+        }
+        report(totals);
+    }
+    catch (std::runtime_error& e)
+    {
+        if (e.what())
+            std::cerr << "ERROR: " << e.what();
+        return 1;
+    }
+    catch (std::exception& e)
+    {
+        if (e.what())
+            std::cerr << "exception: " << e.what();
+        std::cerr << "Unhandled exception!" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,113 @@
+#include "ArgParser.h"
+#include "Test.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <cstdlib>
+#include <unistd.h>
+#include <sys/wait.h>
+
+// parse the command line tokens times over in a child process that has
+// telemetry turned on, so that its records are written when it exits, and
+// every flush_every parses before that if it is not zero
+void child(std::string path, std::vector<std::string> tokens, size_t times = 1, size_t flush_every = 0)
+{
+    std::cout << std::flush;
+    pid_t pid = fork();
+    if (pid)
+    {
+        waitpid(pid, 0, 0);
+        return;
+    }
+
+    CppArgParser::telemetry(path.c_str());
+    tokens.insert(tokens.begin(), "TelemetryTest");
+    std::vector<char*> argv;
+    for (auto& token : tokens)
+        argv.push_back(&token[0]);
+    argv.push_back(0);
+
+    for (size_t run = 0; run < times; ++run)
+    {
+        try
+        {
+            ArgParserType::N n = 0;
+            std::vector<ArgParserType::N> n_m;
+            ArgParserType::Str str;
+            ArgParserType::B b;
+            ArgParserType::N unused = 0;
+            bool quiet = false;
+            ArgParserType::N trace = 0;
+
+            CppArgParser::Sink discard([](void*, const char*, size_t) {}, 0);
+            CppArgParser::ArgParser args(argv.size() - 1, &argv[0], "Test the CppArgParser", "", discard);
+            args.env("MYAPP_");
+            args.param(n,      "--n",      "int");
+            args.param(n_m,    "--n_m",    "int (multiple instances)");
+            args.param(str,    "--str",    "std::string");
+            args.param(b,      "--b",      "bool");
+            args.param(unused, "--unused", "int (never given)");
+            args.param(quiet,  "--quiet",  "bool (hidden)", false);
+            args.param(trace,  "--trace",  "int (hidden, never given)", false);
+            args.valid();
+        }
+        catch (std::runtime_error&)
+        {
+        }
+        if (flush_every && (run + 1) % flush_every == 0)
+            CppArgParser::telemetry_flush();
+    }
+    std::exit(0);
+}
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        std::string path = "/tmp/TelemetryTest." + std::to_string(getpid());
+        unlink(path.c_str());
+
+        child(path, { "--n", "3", "--n_m", "1", "--n_m=2" });
+        setenv("MYAPP_STR", "from env", 1);
+        child(path, { "--b", "--quiet" });
+        unsetenv("MYAPP_STR");
+        child(path, { "--n", "x" });
+        child(path, { "--help" });
+        // more records than the buffer holds, flushed as they go
+        child(path, { "--n", "1" }, 1000, 100);
+        // and not: what does not fit is dropped and counted
+        child(path, { "--n", "2" }, 600);
+
+        // TelemetryAgg is built next to this test
+        std::string agg = argv[0];
+        agg = agg.substr(0, agg.find_last_of('/') + 1) + "TelemetryAgg";
+        std::cout << std::flush;
+        pid_t pid = fork();
+        if (!pid)
+        {
+            execl(agg.c_str(), agg.c_str(), path.c_str(), (char*)0);
+            std::cerr << "ERROR: cannot run " << agg << std::endl;
+            std::_Exit(1);
+        }
+        int status = 0;
+        waitpid(pid, &status, 0);
+        unlink(path.c_str());
+        return WIFEXITED(status) ? WEXITSTATUS(status) : 1;
+    }
+    catch (std::runtime_error& e)
+    {
+        if (e.what())
+            std::cerr << "ERROR: " << e.what();
+        return 1;
+    }
+    catch (std::exception& e)
+    {
+        if (e.what())
+            std::cerr << "exception: " << e.what();
+        std::cerr << "Unhandled exception!" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
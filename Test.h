@@ -1,4 +1,5 @@
 #include "ArgParser.h"
+#include <iostream>
 #include <string>
 
 // list of built-in types we support
@@ -0,0 +1,101 @@
+#!/usr/bin/env python
+"""Compare build time and size of the header-only ArgParser.h against the
+slim ArgParserLib.h linked with the compiled CppArgParser library.
+
+Generates a number of translation units that each add a few parameters of
+built-in types, then compiles and links them once per mode.
+"""
+from __future__ import print_function
+import os, sys, time, shutil, tempfile, subprocess
+
+TU = """#include "{header}"
+#include <string>
+#include <vector>
+
+void module{index}(CppArgParser::ArgParser& args)
+{{
+    static int n = 0;
+    static std::string str;
+    static std::vector<int> n_m;
+    static CppArgParser::Bool b;
+    args.param(n, "--n{index}", "int");
+    args.param(str, "--str{index}", "std::string");
+    args.param(n_m, "--n_m{index}", "int (multiple instances)");
+    args.param(b, "--b{index}", "bool");
+}}
+"""
+
+MAIN = """#include "{header}"
+
+{declarations}
+
+int main(int argc, char* argv[])
+{{
+    CppArgParser::ArgParser args(argc, argv, "build benchmark");
+{calls}
+    return args.valid() ? 0 : 1;
+}}
+"""
+
+def run(cmd):
+    subprocess.check_call(cmd)
+
+def build(options, workdir, header, library):
+    srcdir = os.path.dirname(os.path.abspath(__file__))
+    sources = []
+    for index in range(options.tus):
+        name = os.path.join(workdir, 'tu{0}.cpp'.format(index))
+        with open(name, 'w') as out:
+            out.write(TU.format(header=header, index=index))
+        sources.append(name)
+    main = os.path.join(workdir, 'main.cpp')
+    with open(main, 'w') as out:
+        out.write(MAIN.format(header=header,
+            declarations='\n'.join('void module{0}(CppArgParser::ArgParser&);'.format(i) for i in range(options.tus)),
+            calls='\n'.join('    module{0}(args);'.format(i) for i in range(options.tus))))
+    sources.append(main)
+    if library:
+        sources.append(os.path.join(srcdir, 'ArgParser.cpp'))
+
+    flags = [options.cxx, '-std=c++0x', options.opt, '-I', srcdir, '-c']
+    start = time.time()
+    objects = []
+    for source in sources:
+        obj = source.replace('.cpp', '.o')
+        if source.startswith(srcdir):
+            obj = os.path.join(workdir, 'ArgParser.o')
+        run(flags + [source, '-o', obj])
+        objects.append(obj)
+    binary = os.path.join(workdir, 'bench')
+    run([options.cxx] + objects + ['-o', binary])
+    elapsed = time.time() - start
+    return elapsed, sum(os.path.getsize(o) for o in objects), os.path.getsize(binary)
+
+def main(options):
+    results = []
+    for label, header, library in (('header-only', 'ArgParser.h', False),
+                                   ('library', 'ArgParserLib.h', True)):
+        workdir = tempfile.mkdtemp(prefix='buildbench')
+        try:
+            results.append((label,) + build(options, workdir, header, library))
+        finally:
+            shutil.rmtree(workdir)
+
+    print('{0} translation units, {1} {2}'.format(options.tus, options.cxx, options.opt))
+    print('{0:<12} {1:>10} {2:>12} {3:>12}'.format('mode', 'build (s)', 'objects (B)', 'binary (B)'))
+    for label, elapsed, objects, binary in results:
+        print('{0:<12} {1:>10.2f} {2:>12} {3:>12}'.format(label, elapsed, objects, binary))
+    return 0
+
+if __name__ == "__main__":
+    import argparse
+    parser = argparse.ArgumentParser(description="ArgParser build time benchmark")
+    parser.add_argument('--tus', type=int, default=20,
+                        help="number of translation units (default=20)")
+    parser.add_argument('--cxx', default=os.environ.get('CXX', 'c++'),
+                        help="compiler (default=$CXX or c++)")
+    parser.add_argument('--opt', default='-O2',
+                        help="optimization flag (default=-O2)")
+    args = parser.parse_args()
+
+    sys.exit(main(args))